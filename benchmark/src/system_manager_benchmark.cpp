@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2026 by GallenShao, All Rights Reserved.
+ *
+ * system_manager_benchmark.cpp
+ *
+ *  Created on: 2026.10.17
+ *  Author: gallenshao
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <chrono>
+#include <utility>
+
+#include "gs_ecs.h"
+
+/**
+ * 每帧调度开销的基准测试，System本身不做任何事(或空转固定时长)，覆盖：
+ *   shape 0, chain:   0 -> 1 -> ... -> n-1
+ *   shape 1, fan:     0 -> {1 ... n-1}
+ *   shape 2, diamond: 0 -> {1 ... n-2} -> n-1
+ *
+ * 结果中time/system为每个System分摊的调度耗时，threads为默认线程数
+ */
+
+#define MAX_NODE_COUNT 512
+
+enum Shape { CHAIN, FAN, DIAMOND };
+
+// busy time of every system in nanoseconds, 0 measures the scheduler alone
+static int64_t work_ns = 0;
+
+template <int I>
+class NodeSystem : public gs::System<NodeSystem<I>> {
+ public:
+  void Update(gs::EntityManager& manager) override {
+    if (work_ns > 0) {
+      auto end = std::chrono::steady_clock::now() + std::chrono::nanoseconds(work_ns);
+      while (std::chrono::steady_clock::now() < end) {
+      }
+    }
+  }
+};
+
+template <int I>
+void AddNode(gs::SystemManager& manager, gs::SystemGroup& middle, Shape shape, int count) {
+  typedef NodeSystem<I> Node;
+  typedef NodeSystem<(I > 0 ? I - 1 : 0)> Previous;
+  if (I == 0) {
+    manager.AddSystem<Node>();
+  } else if (shape == CHAIN) {
+    manager.AddSystem<Node>().template WhichDependsOn<Previous>();
+  } else if (shape == FAN) {
+    manager.AddSystem<Node>().template WhichDependsOn<NodeSystem<0>>();
+  } else if (I < count - 1) {
+    middle.AddSystem<Node>();
+  } else {
+    manager.AddSystemGroup(middle).WhichDependsOn<NodeSystem<0>>();
+    manager.AddSystem<Node>().WhichDependsOn(middle);
+  }
+}
+
+typedef void (*AddNodeFunc)(gs::SystemManager&, gs::SystemGroup&, Shape, int);
+
+template <int... Is>
+constexpr std::array<AddNodeFunc, sizeof...(Is)> MakeAddNodeTable(std::integer_sequence<int, Is...>) {
+  return {&AddNode<Is>...};
+}
+
+static const auto add_node_table = MakeAddNodeTable(std::make_integer_sequence<int, MAX_NODE_COUNT>());
+
+template <typename T>
+void BM_Frame(benchmark::State& state) {
+  auto shape = static_cast<Shape>(state.range(0));
+  auto count = static_cast<int>(state.range(1));
+  auto threads = static_cast<int>(state.range(2));
+  work_ns = state.range(3);
+
+  auto manager = gs::SystemManager::MakeFromTraverser<T>();
+  gs::SystemGroup middle;
+  for (int index = 0; index < count; index++) {
+    add_node_table[index](*manager, middle, shape, count);
+  }
+  manager->SetMaxThreadCount(threads);
+
+  gs::EntityManager entities;
+  manager->Configure(entities);
+  manager->Update(entities);
+
+  for (auto _ : state) {
+    manager->Update(entities);
+  }
+
+  // seconds per system, printed with an SI prefix, e.g. 480ns
+  state.counters["time/system"] = benchmark::Counter(static_cast<double>(state.iterations()) * count,
+                                                   benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+  work_ns = 0;
+}
+
+static void SingleThreadArguments(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgNames({"shape", "systems", "threads", "work_ns"});
+  for (auto shape : {CHAIN, FAN, DIAMOND}) {
+    for (auto count : {4, 16, 64, 256, MAX_NODE_COUNT}) {
+      benchmark->Args({shape, count, 1, 0});
+    }
+  }
+}
+
+static void MultiThreadArguments(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgNames({"shape", "systems", "threads", "work_ns"});
+  for (auto shape : {CHAIN, FAN, DIAMOND}) {
+    for (auto count : {4, 16, 64, 256, MAX_NODE_COUNT}) {
+      for (auto threads : {1, 2, 4, 8}) {
+        benchmark->Args({shape, count, threads, 0});
+      }
+    }
+  }
+  // thread scaling with some work in every system
+  for (auto threads : {1, 2, 4, 8}) {
+    benchmark->Args({FAN, 64, threads, 10000});
+  }
+}
+
+BENCHMARK_TEMPLATE(BM_Frame, gs::SingleThreadTraverser)->Apply(SingleThreadArguments)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_Frame, gs::MultiThreadTraverser)->Apply(MultiThreadArguments)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_Frame, gs::WorkStealingTraverser)->Apply(MultiThreadArguments)->UseRealTime();
@@ -0,0 +1,73 @@
+/**
+ * Copyright 2026 by GallenShao, All Rights Reserved.
+ *
+ * affinity.h
+ *
+ *  Created on: 2026.10.17
+ *  Author: gallenshao
+ */
+
+#pragma once
+
+#include <bitset>
+#include <cstddef>
+#include <vector>
+
+namespace gs {
+
+#define MAX_CPU_COUNT 1024
+
+// bit i is the logical CPU i
+typedef std::bitset<MAX_CPU_COUNT> CpuSet;
+
+/**
+ * 一种线程(SystemThread)的CPU亲和性，见SystemManager::SetThreadAffinity：
+ *   1. 线程固定在cpus以及nodes中各NUMA节点的CPU上运行，两者都为空时不做任何限制
+ *   2. one_cpu_per_thread时第i个线程只绑定集合中第i个CPU(循环使用)，否则每个线程可在整个集合内调度
+ *
+ * Example:
+ *
+ * // the default threads stay on the first socket, one per core
+ * auto affinity = gs::ThreadAffinity::Node(0);
+ * affinity.one_cpu_per_thread = true;
+ * manager->SetThreadAffinity(affinity);
+ */
+struct ThreadAffinity {
+  CpuSet cpus;
+  std::vector<int> nodes;
+  bool one_cpu_per_thread = false;
+
+  static ThreadAffinity Node(int node);
+  static ThreadAffinity Cpus(const std::vector<int>& cpus);
+
+  bool Empty() const { return cpus.none() && nodes.empty(); }
+  // the CPUs the `index`-th thread of the family runs on, none if it is not pinned
+  CpuSet Resolve(int index) const;
+};
+
+/**
+ * 平台相关的CPU与NUMA查询，在不支持的平台上退化为单节点，绑定操作返回false
+ */
+class Affinity {
+ public:
+  static int CpuCount();
+  // NUMA nodes of the machine, 1 if unknown
+  static int NodeCount();
+  // ids of the online NUMA nodes in ascending order, they are not always contiguous. {0} if unknown
+  static std::vector<int> Nodes();
+  // CPUs of `node`, every CPU for node 0 if the topology is unknown
+  static CpuSet NodeCpus(int node);
+  // node of the CPU the calling thread is running on, 0 if unknown
+  static int CurrentNode();
+
+  // restrict the calling thread to `cpus`, return false if the platform refuses
+  static bool PinCurrentThread(const CpuSet& cpus);
+  // CPUs the calling thread may run on
+  static CpuSet CurrentThreadCpus();
+
+  // prefer placing the pages of [ptr, ptr + size) on `node`, `ptr` must be page aligned.
+  // Return false if the platform refuses, the pages then follow the first thread touching them
+  static bool BindMemory(void* ptr, size_t size, int node);
+};
+
+}  // namespace gs
@@ -0,0 +1,121 @@
+/**
+ * Copyright 2026 by GallenShao, All Rights Reserved.
+ *
+ * allocator.h
+ *
+ *  Created on: 2026.10.17
+ *  Author: gallenshao
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace gs {
+
+#define CHUNK_SIZE (16 * 1024)
+#define CHUNK_ALIGNMENT 64
+// chunk columns have room for a multiple of this many rows, see View::ForEachBatch
+#define MAX_BATCH_SIZE 16
+// a ChunkPool caches at most this many released bytes by default, the rest goes back to the heap
+#define DEFAULT_POOL_CACHE_SIZE (4 * 1024 * 1024)
+// NodeLocalChunkAllocator maps memory from each node by slabs of this size
+#define NODE_SLAB_SIZE (2 * 1024 * 1024)
+
+/**
+ * 大块内存的分配接口，Archetype的Chunk以及LinearArena的内存块都从这里申请，
+ * 可通过EntityManager、SystemManager替换为自定义实现
+ */
+class ChunkAllocator {
+ public:
+  virtual ~ChunkAllocator() = default;
+
+  // `size` bytes aligned to CHUNK_ALIGNMENT
+  virtual void* Allocate(size_t size) = 0;
+  // `size` is the one passed to `Allocate`
+  virtual void Deallocate(void* ptr, size_t size) = 0;
+};
+
+class HeapChunkAllocator : public ChunkAllocator {
+ public:
+  void* Allocate(size_t size) override;
+  void Deallocate(void* ptr, size_t size) override;
+};
+
+/**
+ * 定长内存池：释放的块按大小缓存，之后申请相同大小时直接复用，
+ * 避免实体反复增删时频繁malloc/free以及长时间运行后的内存碎片，线程安全
+ */
+class ChunkPool : public ChunkAllocator {
+ public:
+  // blocks beyond `max_cached_bytes` are returned to the heap, so that a long running process shrinks again after
+  // a peak. Pass SIZE_MAX to keep every released block
+  explicit ChunkPool(size_t max_cached_bytes = DEFAULT_POOL_CACHE_SIZE) : max_cached_bytes_(max_cached_bytes) {}
+  ~ChunkPool() override;
+
+  void* Allocate(size_t size) override;
+  void Deallocate(void* ptr, size_t size) override;
+
+  // return all cached blocks to the heap
+  void Trim();
+  size_t cached_bytes() const;
+
+ private:
+  const size_t max_cached_bytes_;
+  HeapChunkAllocator heap_;
+
+  mutable std::mutex lock_;
+  std::unordered_map<size_t, std::vector<void*>> free_blocks_;
+  size_t cached_bytes_ = 0;
+};
+
+/**
+ * 按NUMA节点分配的内存池：从调用线程当前所在节点的内存申请，释放的块回到其所属节点的缓存中复用，
+ * 配合SystemManager::SetThreadAffinity，被固定在某节点上的线程创建的Chunk位于本地内存，线程安全
+ *
+ * Example:
+ *
+ * gs::EntityManager world(std::make_shared<gs::NodeLocalChunkAllocator>());
+ */
+class NodeLocalChunkAllocator : public ChunkAllocator {
+ public:
+  NodeLocalChunkAllocator();
+  ~NodeLocalChunkAllocator() override;
+
+  void* Allocate(size_t size) override;
+  void Deallocate(void* ptr, size_t size) override;
+
+  // node whose memory `ptr` was allocated from, -1 if it does not come from this allocator
+  int NodeOf(const void* ptr) const;
+  size_t node_count() const { return node_count_; }
+
+ private:
+  struct Node {
+    std::mutex lock;
+    std::unordered_map<size_t, std::vector<void*>> free_blocks;
+    // blocks are carved from the current slab of the node
+    uint8_t* slab = nullptr;
+    size_t slab_used = 0;
+  };
+
+  // map `size` bytes bound to `node`, throw std::bad_alloc if the mapping fails
+  uint8_t* Map(size_t size, int node);
+
+  // indexed by node id, nullptr for the ids which are not online
+  std::vector<std::unique_ptr<Node>> nodes_;
+  size_t node_count_ = 0;
+  // used when the calling thread runs on a node unknown at construction
+  int default_node_ = 0;
+
+  // every mapping by address, to find the node of a released block
+  mutable std::mutex mappings_lock_;
+  std::map<const uint8_t*, std::pair<size_t, int>> mappings_;
+};
+
+}  // namespace gs
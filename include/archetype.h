@@ -0,0 +1,111 @@
+/**
+ * Copyright 2026 by GallenShao, All Rights Reserved.
+ *
+ * archetype.h
+ *
+ *  Created on: 2026.10.17
+ *  Author: gallenshao
+ */
+
+#pragma once
+
+#include "allocator.h"
+#include "component.h"
+#include "entity.h"
+#include <cstdint>
+#include <vector>
+
+namespace gs {
+
+/**
+ * Chunk是一块固定大小的内存，按列(SoA)存放同一Archetype下若干实体，末尾是每列最后一次写入的Tick。
+ * 每列起始地址按CHUNK_ALIGNMENT对齐，行数rows为容量向上取整到MAX_BATCH_SIZE的倍数，供批量遍历越过末尾读写：
+ *
+ * | entities[rows] | column 0[rows] | column 1[rows] | ... | ticks[column count] |
+ */
+struct Chunk {
+  uint8_t* data = nullptr;
+  int size = 0;
+};
+
+/**
+ * Archetype存放拥有相同组件集合的所有实体，除最后一个Chunk外，其余Chunk均是满的
+ */
+class Archetype {
+ public:
+  // chunks are allocated from `allocator`, which must outlive the archetype
+  Archetype(const ComponentMask& mask, ChunkAllocator& allocator);
+  ~Archetype();
+
+  Archetype(const Archetype&) = delete;
+  Archetype& operator=(const Archetype&) = delete;
+
+  const ComponentMask& mask() const { return mask_; }
+  const std::vector<ComponentBase::Family>& families() const { return families_; }
+  size_t size() const { return size_; }
+  int chunk_capacity() const { return chunk_capacity_; }
+  const std::vector<Chunk>& chunks() const { return chunks_; }
+
+  bool Has(ComponentBase::Family family) const {
+    return family < column_index_.size() && column_index_[family] >= 0;
+  }
+
+  Entity* Entities(const Chunk& chunk) const { return reinterpret_cast<Entity*>(chunk.data); }
+
+  // column of `family` in `chunk`, nullptr if this archetype does not have it
+  void* Column(const Chunk& chunk, ComponentBase::Family family) const {
+    return Has(family) ? chunk.data + column_offsets_[column_index_[family]] : nullptr;
+  }
+
+  template <typename T>
+  T* Column(const Chunk& chunk) const {
+    return static_cast<T*>(Column(chunk, T::family()));
+  }
+
+  // tick of the last write to the column of `family` in `chunk`, the archetype must have `family`
+  Tick ColumnTick(const Chunk& chunk, ComponentBase::Family family) const {
+    return Ticks(chunk)[column_index_[family]];
+  }
+  void MarkWritten(const Chunk& chunk, ComponentBase::Family family, Tick tick) const {
+    Ticks(chunk)[column_index_[family]] = tick;
+  }
+  void MarkWritten(size_t row, ComponentBase::Family family, Tick tick) const {
+    MarkWritten(chunks_[row / chunk_capacity_], family, tick);
+  }
+
+  Entity EntityAt(size_t row) const;
+  void* At(size_t row, ComponentBase::Family family) const;
+
+  // append `entity` with uninitialized components, return its row,
+  // all columns of the chunk it lands in are marked as written at `tick`
+  size_t Push(Entity entity, Tick tick);
+
+  // remove `row` whose components were already destroyed or relocated,
+  // the last row is relocated into the hole and its entity is returned
+  Entity EraseRelocated(size_t row, Tick tick);
+
+  // destroy all components of `row` then remove it, see `EraseRelocated`
+  Entity Erase(size_t row, Tick tick);
+
+ private:
+  Tick* Ticks(const Chunk& chunk) const { return reinterpret_cast<Tick*>(chunk.data + ticks_offset_); }
+  void MarkChunkWritten(const Chunk& chunk, Tick tick) const;
+
+  ComponentMask mask_;
+  ChunkAllocator& allocator_;
+  std::vector<ComponentBase::Family> families_;
+  std::vector<ComponentBase::Info> infos_;
+  std::vector<int> column_index_;
+  std::vector<size_t> column_offsets_;
+  size_t ticks_offset_ = 0;
+
+  size_t chunk_bytes_ = CHUNK_SIZE;
+  int chunk_capacity_ = 0;
+  std::vector<Chunk> chunks_;
+  size_t size_ = 0;
+
+  friend class Snapshot;
+  friend class FrameSnapshot;
+};
+
+}  // namespace gs
@@ -0,0 +1,63 @@
+/**
+ * Copyright 2026 by GallenShao, All Rights Reserved.
+ *
+ * arena.h
+ *
+ *  Created on: 2026.10.17
+ *  Author: gallenshao
+ */
+
+#pragma once
+
+#include "allocator.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace gs {
+
+#define ARENA_BLOCK_SIZE (64 * 1024)
+
+/**
+ * 线性(bump)分配器：分配只移动指针，不能单独释放，Reset后整体复用已申请的内存块
+ * 不会调用对象的析构函数，非线程安全
+ */
+class LinearArena {
+ public:
+  // blocks come from `allocator`, or the heap if it is nullptr
+  explicit LinearArena(std::shared_ptr<ChunkAllocator> allocator = nullptr, size_t block_size = ARENA_BLOCK_SIZE);
+  ~LinearArena();
+
+  LinearArena(const LinearArena&) = delete;
+  LinearArena& operator=(const LinearArena&) = delete;
+
+  void* Allocate(size_t size, size_t align);
+
+  template <typename T, typename... Args>
+  T* New(Args&&... args) {
+    return new (Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+  }
+
+  // release everything allocated, the blocks are kept for reuse
+  void Reset();
+
+  size_t used() const { return used_; }
+
+ private:
+  struct Block {
+    uint8_t* data = nullptr;
+    size_t size = 0;
+  };
+
+  std::shared_ptr<ChunkAllocator> allocator_;
+  const size_t block_size_;
+  std::vector<Block> blocks_;
+  size_t current_ = 0;
+  size_t offset_ = 0;
+  size_t used_ = 0;
+};
+
+}  // namespace gs
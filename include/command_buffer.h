@@ -0,0 +1,87 @@
+/**
+ * Copyright 2026 by GallenShao, All Rights Reserved.
+ *
+ * command_buffer.h
+ *
+ *  Created on: 2026.10.17
+ *  Author: gallenshao
+ */
+
+#pragma once
+
+#include "arena.h"
+#include "component.h"
+#include "entity.h"
+#include <cstdint>
+#include <vector>
+
+namespace gs {
+
+/**
+ * 延迟执行的实体结构变更(创建、销毁、添加/删除组件)，功能：
+ *   1. 命令及组件数据存放在线性分配器中，录制时没有额外的堆分配
+ *   2. Playback按录制顺序在EntityManager上执行，之后清空复用
+ *   3. Create返回的实体在Playback前只能用于同一个CommandBuffer的命令
+ *
+ * 并行运行的System通过BaseSystem::Commands()取得当前线程的CommandBuffer，
+ * SystemManager在同步点(见System::SyncPoint)及每帧结束时统一Playback
+ *
+ * Example:
+ *
+ * void Update(gs::EntityManager& manager) override {
+ *   auto bullet = Commands().Create();
+ *   Commands().Assign<Position>(bullet, 1.f, 2.f);
+ *   Commands().Destroy(target);
+ * }
+ */
+class CommandBuffer {
+ public:
+  // the commands are stored in blocks from `allocator`, or the heap if it is nullptr
+  explicit CommandBuffer(std::shared_ptr<ChunkAllocator> allocator = nullptr) : arena_(std::move(allocator)) {}
+  ~CommandBuffer();
+
+  CommandBuffer(const CommandBuffer&) = delete;
+  CommandBuffer& operator=(const CommandBuffer&) = delete;
+
+  Entity Create();
+  void Destroy(Entity entity);
+
+  template <typename T, typename... Args>
+  typename std::enable_if<std::is_base_of<Component<T>, T>::value, void>::type Assign(Entity entity, Args&&... args);
+
+  template <typename T>
+  typename std::enable_if<std::is_base_of<Component<T>, T>::value, void>::type Remove(Entity entity);
+
+  bool Empty() const { return head_ == nullptr; }
+
+  // commands on entities which are no longer valid are skipped
+  void Playback(EntityManager& manager);
+  // drop all commands without running them
+  void Clear();
+
+ private:
+  // version of the entities returned by `Create`, their index is the creation order in this buffer
+  static constexpr Entity::Version PENDING_VERSION = Entity::RESERVED_VERSION;
+
+  enum CommandType { CREATE, DESTROY, ASSIGN, REMOVE };
+
+  struct Command {
+    CommandType type;
+    Entity entity;
+    ComponentBase::Family family = 0;
+    // constructed in the arena, relocated into the entity on playback
+    void* component = nullptr;
+    Command* next = nullptr;
+  };
+
+  Command* Append(CommandType type, Entity entity, ComponentBase::Family family = 0);
+  Entity Resolve(Entity entity) const;
+
+  LinearArena arena_;
+  Command* head_ = nullptr;
+  Command* tail_ = nullptr;
+  Entity::Index pending_count_ = 0;
+  std::vector<Entity> created_;
+};
+
+}  // namespace gs
@@ -0,0 +1,26 @@
+/**
+ * Copyright 2026 by GallenShao, All Rights Reserved.
+ *
+ * command_buffer.hpp
+ *
+ *  Created on: 2026.10.17
+ *  Author: gallenshao
+ */
+
+#pragma once
+
+#include "command_buffer.h"
+#include "component.hpp"
+
+template <typename T, typename... Args>
+typename std::enable_if<std::is_base_of<gs::Component<T>, T>::value, void>::type
+gs::CommandBuffer::Assign(Entity entity, Args&&... args) {
+  auto command = Append(ASSIGN, entity, T::family());
+  command->component = arena_.New<T>(std::forward<Args>(args)...);
+}
+
+template <typename T>
+typename std::enable_if<std::is_base_of<gs::Component<T>, T>::value, void>::type
+gs::CommandBuffer::Remove(Entity entity) {
+  Append(REMOVE, entity, T::family());
+}
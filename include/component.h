@@ -9,20 +9,109 @@
 
 #pragma once
 
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
 namespace gs {
 
+#define MAX_COMPONENT_COUNT 256
+
 class ComponentBase {
  public:
   typedef int Family;
 
+  /**
+   * 组件的类型擦除信息，Archetype按列存放组件时通过它移动、析构组件
+   */
+  struct Info {
+    size_t size = 0;
+    size_t align = 0;
+    // move-construct `src` into uninitialized `dst`, then destroy `src`
+    void (*relocate)(void* dst, void* src) = nullptr;
+    void (*destroy)(void* ptr) = nullptr;
+    // stored in a SparseSet instead of the archetype columns, see Component<T>::SparseStorage
+    bool sparse = false;
+    // raw bytes can be saved and restored, see Snapshot
+    bool trivially_copyable = false;
+    // identifies the type across processes, see Component<T>::SnapshotName
+    const char* name = nullptr;
+  };
+
+  static const Info& GetInfo(Family family);
+  // family of the registered component named `name`, -1 if there is none
+  static Family FindFamily(const char* name);
+
  protected:
+  static Family Register(const Info& info);
+
+ private:
+  static std::vector<Info>& infos();
+
   static Family family_count_;
 };
 
+typedef std::bitset<MAX_COMPONENT_COUNT> ComponentMask;
+
+// version of component data, EntityManager stamps every write with its current tick, see SystemManager::Update
+typedef uint64_t Tick;
+
+/**
+ * Example:
+ *
+ * struct Position : public gs::Component<Position> {
+ *   float x = 0;
+ *   float y = 0;
+ * };
+ *
+ * // toggled often, adding or removing it does not move the entity to another archetype
+ * struct Stunned : public gs::Component<Stunned> {
+ *   static constexpr bool SparseStorage = true;
+ * };
+ */
 template <typename T>
 class Component : public ComponentBase {
  public:
   static Family family();
+
+  // kept in a SparseSet of its own, override with true in T. Sparse components are not part of the archetype,
+  // they are not visited by View and have no change ticks, use EntityManager::ForEachSparse to iterate them
+  static constexpr bool SparseStorage = false;
+
+  // stable name stored in snapshots instead of the family, which depends on instantiation order. Defaults to the
+  // mangled type name, which is only stable for the same compiler ABI, override it in T to rename the type freely
+  static constexpr const char* SnapshotName = nullptr;
+};
+
+/**
+ * 流水线模式下T在每帧结束时发布的副本，供后一阶段的System读取，见SystemManager::EnablePipelining
+ */
+template <typename T>
+struct Published : public Component<Published<T>> {
+  T value;
+};
+
+/**
+ * 组件类型列表，const修饰的组件表示只读访问
+ *
+ * Example:
+ *
+ * typedef gs::ComponentList<Position, const Velocity> List;
+ * List::mask();        // Position | Velocity
+ * List::write_mask();  // Position
+ */
+template <typename... Ts>
+struct ComponentList {
+  static_assert((std::is_base_of<Component<typename std::remove_const<Ts>::type>,
+                                 typename std::remove_const<Ts>::type>::value && ...),
+                "ComponentList only accepts gs::Component types");
+
+  static const ComponentMask& mask();
+  static const ComponentMask& write_mask();
 };
 
 }  // namespace gs
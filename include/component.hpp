@@ -10,9 +10,41 @@
 #pragma once
 
 #include "component.h"
+#include <typeinfo>
 
 template <typename T>
 gs::ComponentBase::Family gs::Component<T>::family() {
-  static Family family = family_count_++;
+  static Family family = Register({
+      sizeof(T),
+      alignof(T),
+      [](void* dst, void* src) {
+        new (dst) T(std::move(*static_cast<T*>(src)));
+        static_cast<T*>(src)->~T();
+      },
+      [](void* ptr) { static_cast<T*>(ptr)->~T(); },
+      T::SparseStorage,
+      std::is_trivially_copyable<T>::value,
+      T::SnapshotName != nullptr ? T::SnapshotName : typeid(T).name(),
+  });
   return family;
-}
\ No newline at end of file
+}
+
+template <typename... Ts>
+const gs::ComponentMask& gs::ComponentList<Ts...>::mask() {
+  static ComponentMask mask = []() {
+    ComponentMask mask;
+    (mask.set(std::remove_const<Ts>::type::family()), ...);
+    return mask;
+  }();
+  return mask;
+}
+
+template <typename... Ts>
+const gs::ComponentMask& gs::ComponentList<Ts...>::write_mask() {
+  static ComponentMask mask = []() {
+    ComponentMask mask;
+    ((std::is_const<Ts>::value ? mask : mask.set(std::remove_const<Ts>::type::family())), ...);
+    return mask;
+  }();
+  return mask;
+}
@@ -9,16 +9,167 @@
 
 #pragma once
 
+#include "allocator.h"
+#include "component.h"
+#include <cstdint>
 #include <memory>
+#include <unordered_map>
+#include <vector>
 
 namespace gs {
 
+class Archetype;
+class SparseSet;
+
+template <typename... Ts>
+class View;
+
+/**
+ * 实体句柄，低32位为槽位下标，高32位为版本号：
+ * 槽位被回收复用时版本号递增，持有旧版本号的句柄即失效，校验时无需任何查找
+ */
 class Entity {
+ public:
+  typedef uint64_t Id;
+  typedef uint32_t Index;
+  typedef uint32_t Version;
+  static constexpr Id INVALID_ID = UINT64_MAX;
+  // never used by a slot, slot versions wrap around before reaching it. Marks handles which do not refer to a slot
+  // yet, see CommandBuffer::Create
+  static constexpr Version RESERVED_VERSION = UINT32_MAX;
+
+  Entity() = default;
+  explicit Entity(Id id) : id_(id) {}
+  Entity(Index index, Version version) : id_(static_cast<Id>(version) << 32 | index) {}
+
+  Id id() const { return id_; }
+  Index index() const { return static_cast<Index>(id_); }
+  Version version() const { return static_cast<Version>(id_ >> 32); }
+
+  bool operator==(const Entity& other) const { return id_ == other.id_; }
+  bool operator!=(const Entity& other) const { return id_ != other.id_; }
 
+ private:
+  Id id_ = INVALID_ID;
 };
 
+/**
+ * 实体与组件的存储，功能：
+ *   1. 组件按Archetype(组件集合)分组，以Component<T>::family()为列标识
+ *   2. 每个Archetype内组件按列(SoA)存放在固定大小的Chunk中，遍历相同组件集合的实体时内存连续
+ *   3. 实体槽位通过空闲链表回收复用，Create/Destroy均为O(1)
+ *   4. Chunk内存来自可替换的ChunkAllocator，默认使用ChunkPool缓存复用释放的Chunk
+ *   5. 每个Chunk记录每列最后一次写入的Tick，查询可跳过自某个Tick以来未变化的Chunk，见View::ChangedSince
+ *   6. 声明了SparseStorage的组件存放在独立的SparseSet中，增删时实体不会在Archetype之间移动
+ *
+ * Example:
+ *
+ * struct Position : public gs::Component<Position> {
+ *   float x = 0;
+ *   float y = 0;
+ * };
+ *
+ * gs::EntityManager manager;
+ * auto entity = manager.Create();
+ * manager.Assign<Position>(entity).x = 1;
+ * manager.Get<Position>(entity)->y = 2;
+ * manager.Remove<Position>(entity);
+ * manager.Destroy(entity);
+ *
+ * manager.View<Position, const Velocity>().ForEach([](Position& position, const Velocity& velocity) {
+ *   position.x += velocity.x;
+ * });
+ */
 class EntityManager {
+ public:
+  // a ChunkPool of its own is created if `allocator` is nullptr, it can be shared between managers
+  explicit EntityManager(std::shared_ptr<ChunkAllocator> allocator = nullptr);
+  ~EntityManager();
+
+  EntityManager(const EntityManager&) = delete;
+  EntityManager& operator=(const EntityManager&) = delete;
+
+  Entity Create();
+  void Destroy(Entity entity);
+  bool Valid(Entity entity) const;
+  size_t Size() const { return size_; }
+
+  template <typename T, typename... Args>
+  typename std::enable_if<std::is_base_of<Component<T>, T>::value, T&>::type Assign(Entity entity, Args&&... args);
+
+  template <typename T>
+  typename std::enable_if<std::is_base_of<Component<T>, T>::value, void>::type Remove(Entity entity);
+
+  template <typename T>
+  typename std::enable_if<std::is_base_of<Component<T>, T>::value, bool>::type Has(Entity entity) const;
+
+  // the component is marked as written, use `Has` to only check for it
+  template <typename T>
+  typename std::enable_if<std::is_base_of<Component<T>, T>::value, T*>::type Get(Entity entity);
+
+  template <typename... Ts>
+  gs::View<Ts...> View();
+
+  // func(Entity, T&) or func(T&) for every entity having the sparse component T,
+  // components of T must not be added or removed meanwhile
+  template <typename T, typename F>
+  typename std::enable_if<T::SparseStorage, void>::type ForEachSparse(F&& func);
+
+  const std::vector<std::unique_ptr<Archetype>>& archetypes() const { return archetypes_; }
+  const std::shared_ptr<ChunkAllocator>& allocator() const { return allocator_; }
+
+  // writes outside systems are stamped with this tick, SystemManager advances it every frame
+  Tick tick() const { return tick_; }
+  void SetTick(Tick tick) { tick_ = tick; }
+
+  // tick stamped by writes on the calling thread: the one of the running system, otherwise `tick()`
+  Tick WriteTick() const { return thread_tick_ != 0 ? thread_tick_ : tick_; }
+  // set by SystemManager around each system, 0 clears it, return the previous one
+  static Tick SetThreadTick(Tick tick);
+  static Tick thread_tick() { return thread_tick_; }
+
+ private:
+  struct Location {
+    Archetype* archetype = nullptr;
+    size_t row = 0;
+    Entity::Version version = 0;
+  };
+
+  Archetype* GetArchetype(const ComponentMask& mask);
+  void MoveEntity(Location& location, Archetype* target);
+  void* AddComponent(Entity entity, ComponentBase::Family family);
+  void RemoveComponent(Entity entity, ComponentBase::Family family);
+  void* GetComponent(Entity entity, ComponentBase::Family family) const;
+  // `GetComponent` and mark its column as written
+  void* WriteComponent(Entity entity, ComponentBase::Family family);
+  // the set of a sparse component, created on first use
+  SparseSet& GetSparseSet(ComponentBase::Family family);
+  // drop every entity and archetype, then allocate chunks from `allocator`
+  void Reset(std::shared_ptr<ChunkAllocator> allocator);
+  // point the slots at the entities found in the archetype chunks, the other slots are reused in the order of
+  // `free_list` (last one first). False if an entity does not match the version of its slot or is found twice,
+  // if `free_list` is not exactly the other slots, or if a slot has Entity::RESERVED_VERSION
+  bool Relink(const Entity::Index* free_list, size_t free_count);
+
+  // unique among all managers ever created, unlike the address of the manager
+  const uint64_t id_;
+  // declared first, so that it is destroyed after the archetypes
+  std::shared_ptr<ChunkAllocator> allocator_;
+
+  std::vector<Location> locations_;
+  std::vector<Entity::Index> free_list_;
+  std::vector<std::unique_ptr<Archetype>> archetypes_;
+  std::unordered_map<ComponentMask, Archetype*> archetype_index_;
+  // indexed by family, nullptr for archetype components
+  std::vector<std::unique_ptr<SparseSet>> sparse_sets_;
+  size_t size_ = 0;
+  // 0 is older than any write, see View::ChangedSince
+  Tick tick_ = 1;
+  static thread_local Tick thread_tick_;
 
+  friend class CommandBuffer;
+  friend class Snapshot;
+  friend class FrameSnapshot;
 };
 
 }  // namespace gs
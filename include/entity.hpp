@@ -0,0 +1,59 @@
+/**
+ * Copyright 2026 by GallenShao, All Rights Reserved.
+ *
+ * entity.hpp
+ *
+ *  Created on: 2026.10.17
+ *  Author: gallenshao
+ */
+
+#pragma once
+
+#include "archetype.h"
+#include "component.hpp"
+#include "entity.h"
+#include "sparse_set.h"
+
+template <typename T, typename... Args>
+typename std::enable_if<std::is_base_of<gs::Component<T>, T>::value, T&>::type
+gs::EntityManager::Assign(Entity entity, Args&&... args) {
+  auto family = T::family();
+  auto component = static_cast<T*>(WriteComponent(entity, family));
+  if (component != nullptr) {
+    component->~T();
+  } else {
+    component = static_cast<T*>(AddComponent(entity, family));
+  }
+  return *new (component) T(std::forward<Args>(args)...);
+}
+
+template <typename T>
+typename std::enable_if<std::is_base_of<gs::Component<T>, T>::value, void>::type
+gs::EntityManager::Remove(Entity entity) {
+  RemoveComponent(entity, T::family());
+}
+
+template <typename T>
+typename std::enable_if<std::is_base_of<gs::Component<T>, T>::value, bool>::type
+gs::EntityManager::Has(Entity entity) const {
+  return GetComponent(entity, T::family()) != nullptr;
+}
+
+template <typename T>
+typename std::enable_if<std::is_base_of<gs::Component<T>, T>::value, T*>::type
+gs::EntityManager::Get(Entity entity) {
+  return static_cast<T*>(WriteComponent(entity, T::family()));
+}
+
+template <typename T, typename F>
+typename std::enable_if<T::SparseStorage, void>::type gs::EntityManager::ForEachSparse(F&& func) {
+  auto& set = GetSparseSet(T::family());
+  auto& entities = set.entities();
+  for (size_t i = 0; i < entities.size(); i++) {
+    if constexpr (std::is_invocable<F, Entity, T&>::value) {
+      func(entities[i], *static_cast<T*>(set.At(i)));
+    } else {
+      func(*static_cast<T*>(set.At(i)));
+    }
+  }
+}
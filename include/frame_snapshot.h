@@ -0,0 +1,147 @@
+/**
+ * Copyright 2026 by GallenShao, All Rights Reserved.
+ *
+ * frame_snapshot.h
+ *
+ *  Created on: 2026.10.17
+ *  Author: gallenshao
+ */
+
+#pragma once
+
+#include "component.h"
+#include "entity.h"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
+
+namespace gs {
+
+#define FRAME_DELTA_VERSION 2
+#define DEFAULT_SNAPSHOT_HISTORY 8
+
+/**
+ * EntityManager在某一帧的内存快照，用于回滚与网络同步，功能：
+ *   1. 按Chunk的每一列保存组件数据，列数据块以引用计数共享，快照本身不可修改
+ *   2. Capture时根据列的Tick判断，自上一个快照以来未写入的列直接共享上一个快照的数据块，不再拷贝
+ *   3. Diff计算两个快照间每列变化的字节区间，编码为紧凑的二进制增量，Apply在基准快照上应用增量得到新快照
+ *   4. 增量以组件名字(Component<T>::SnapshotName)标识组件，可以在不同进程间传输
+ *   5. 只支持可平凡拷贝(trivially copyable)的组件，包括SparseStorage组件
+ *
+ * Example:
+ *
+ * // server
+ * auto current = gs::FrameSnapshot::Capture(world, previous.get());
+ * auto delta = gs::FrameSnapshot::Diff(*acknowledged, *current);
+ *
+ * // client, `acknowledged` is the snapshot the server diffed against
+ * auto current = gs::FrameSnapshot::Apply(*acknowledged, delta);
+ * current->Restore(world);
+ */
+class FrameSnapshot {
+ public:
+  // empty world, the base of the first delta sent to a client
+  FrameSnapshot() = default;
+
+  // nullptr if a component is not trivially copyable. Columns of `previous`, which must be captured from `manager`,
+  // are shared if they were not written since
+  static std::shared_ptr<const FrameSnapshot> Capture(const EntityManager& manager,
+                                                      const FrameSnapshot* previous = nullptr);
+
+  // delta turning `base` into `target`, columns shared by both take a single byte
+  static std::vector<uint8_t> Diff(const FrameSnapshot& base, const FrameSnapshot& target);
+
+  // nullptr if `delta` is malformed, was not made against `base` or has a component not registered here.
+  // Unchanged columns are shared with `base`
+  static std::shared_ptr<const FrameSnapshot> Apply(const FrameSnapshot& base, const std::vector<uint8_t>& delta);
+
+  // replace all entities of `manager`, handles stay valid across the rollback.
+  // Restored columns are marked as written at `manager.WriteTick()`
+  void Restore(EntityManager& manager) const;
+
+  // tick of the captured manager
+  Tick tick() const { return tick_; }
+  size_t Size() const { return size_; }
+  // bytes of the columns referenced by this snapshot, including the shared ones
+  size_t bytes() const;
+
+ private:
+  typedef std::shared_ptr<const std::vector<uint8_t>> Block;
+
+  struct ChunkState {
+    int size = 0;
+    Block entities;
+    // in the order of ArchetypeState::families
+    std::vector<Block> columns;
+  };
+
+  struct ArchetypeState {
+    ComponentMask mask;
+    // ascending, like the archetype columns
+    std::vector<ComponentBase::Family> families;
+    std::vector<ChunkState> chunks;
+  };
+
+  struct SparseState {
+    ComponentBase::Family family = 0;
+    Block entities;
+    Block components;
+  };
+
+  const ArchetypeState* FindArchetype(const ComponentMask& mask) const;
+  const SparseState* FindSparse(ComponentBase::Family family) const;
+  // every entity is alive in the slot table exactly once, every other slot is free exactly once,
+  // and the blocks have the size of their chunk
+  bool Validate() const;
+
+  // id of the manager captured from, 0 for snapshots made by Apply, which share nothing with later captures.
+  // A manager created at the address of a destroyed one has another id
+  uint64_t source_ = 0;
+  Tick tick_ = 0;
+  size_t size_ = 0;
+  // version of every entity slot
+  Block versions_;
+  // free slots in the order EntityManager reuses them, so that a restored world hands out the same handles
+  Block free_list_;
+  std::vector<ArchetypeState> archetypes_;
+  std::vector<SparseState> sparse_sets_;
+};
+
+/**
+ * 最近若干帧的快照，相邻快照之间共享未变化的列，用于回滚重新模拟
+ *
+ * Example:
+ *
+ * gs::SnapshotHistory history;
+ * systems->Update(world, dt);
+ * history.Capture(world);
+ * ...
+ * // a late input arrived for 3 frames ago
+ * history.Rollback(world, 3);
+ */
+class SnapshotHistory {
+ public:
+  explicit SnapshotHistory(size_t capacity = DEFAULT_SNAPSHOT_HISTORY) : capacity_(capacity) {}
+
+  // capture `manager` on top of the latest snapshot, the oldest one is dropped beyond capacity.
+  // nullptr if a component is not trivially copyable
+  std::shared_ptr<const FrameSnapshot> Capture(const EntityManager& manager);
+
+  // snapshot captured `frames` captures ago, 0 is the latest, nullptr if it is not kept
+  std::shared_ptr<const FrameSnapshot> Get(size_t frames) const;
+
+  // restore `manager` to `Get(frames)` and drop the newer snapshots, false if it is not kept
+  bool Rollback(EntityManager& manager, size_t frames);
+
+  size_t size() const { return snapshots_.size(); }
+  size_t capacity() const { return capacity_; }
+
+ private:
+  size_t capacity_;
+  // the latest at the back
+  std::deque<std::shared_ptr<const FrameSnapshot>> snapshots_;
+};
+
+}  // namespace gs
@@ -10,9 +10,14 @@
 #pragma once
 
 #include "thread.hpp"
+#include "command_buffer.hpp"
 #include "system.hpp"
 #include "component.hpp"
-#include "entity.h"
+#include "entity.hpp"
+#include "view.hpp"
+#include "wait_strategy.hpp"
+#include "frame_snapshot.h"
+#include "snapshot.h"
 
 namespace gs {
 
@@ -0,0 +1,104 @@
+/**
+ * Copyright 2026 by GallenShao, All Rights Reserved.
+ *
+ * lock_free_queue.h
+ *
+ *  Created on: 2026.10.17
+ *  Author: gallenshao
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#define CACHE_LINE_SIZE 64
+
+namespace gs {
+
+/**
+ * 有界无锁多生产者多消费者队列(Dmitry Vyukov)，容量向上取整为2的幂
+ */
+template <typename T>
+class MPMCQueue {
+ public:
+  explicit MPMCQueue(size_t capacity);
+
+  MPMCQueue(const MPMCQueue&) = delete;
+  MPMCQueue& operator=(const MPMCQueue&) = delete;
+
+  // return false if the queue is full
+  bool Push(const T& item);
+  // return false if the queue is empty
+  bool Pop(T& item);
+  // only a hint while other threads are pushing or popping
+  bool Empty() const;
+
+ private:
+  struct Cell {
+    std::atomic<size_t> sequence;
+    T data;
+  };
+
+  std::unique_ptr<Cell[]> cells_;
+  size_t mask_;
+
+  alignas(CACHE_LINE_SIZE) std::atomic<size_t> enqueue_pos_ = {0};
+  alignas(CACHE_LINE_SIZE) std::atomic<size_t> dequeue_pos_ = {0};
+};
+
+/**
+ * 有界无锁工作窃取双端队列(Chase-Lev)：
+ * 所有者线程在底部Push/Pop，其他线程从顶部Steal，容量向上取整为2的幂
+ */
+template <typename T>
+class WorkStealingDeque {
+ public:
+  explicit WorkStealingDeque(size_t capacity);
+
+  WorkStealingDeque(const WorkStealingDeque&) = delete;
+  WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+  // owner only, return false if the deque is full
+  bool Push(const T& item);
+  // owner only, return false if the deque is empty
+  bool Pop(T& item);
+  // any thread, return false if the deque is empty or the item was taken by others
+  bool Steal(T& item);
+  // only a hint while other threads are stealing
+  bool Empty() const;
+
+ private:
+  std::unique_ptr<std::atomic<T>[]> buffer_;
+  int64_t mask_;
+
+  alignas(CACHE_LINE_SIZE) std::atomic<int64_t> top_ = {0};
+  alignas(CACHE_LINE_SIZE) std::atomic<int64_t> bottom_ = {0};
+};
+
+/**
+ * 无锁优先级集合，元素为[0, capacity)内互不重复的整数，Pop总是取出当前最小的元素：
+ * 每个元素占一个bit，Pop按64位字扫描，适合元素数量较少、按排名调度的场景
+ */
+class PrioritySet {
+ public:
+  explicit PrioritySet(size_t capacity) : words_((capacity + 63) / 64) {}
+
+  PrioritySet(const PrioritySet&) = delete;
+  PrioritySet& operator=(const PrioritySet&) = delete;
+
+  // `item` must not be in the set
+  void Push(int item);
+  // return false if the set is empty
+  bool Pop(int& item);
+  // only a hint while other threads are pushing or popping
+  bool Empty() const;
+
+ private:
+  std::vector<std::atomic<uint64_t>> words_;
+};
+
+}  // namespace gs
@@ -0,0 +1,173 @@
+/**
+ * Copyright 2026 by GallenShao, All Rights Reserved.
+ *
+ * lock_free_queue.hpp
+ *
+ *  Created on: 2026.10.17
+ *  Author: gallenshao
+ */
+
+#pragma once
+
+#include "lock_free_queue.h"
+
+namespace gs {
+
+static inline size_t RoundUpToPowerOfTwo(size_t value) {
+  size_t result = 1;
+  while (result < value) {
+    result <<= 1;
+  }
+  return result;
+}
+
+}  // namespace gs
+
+template <typename T>
+gs::MPMCQueue<T>::MPMCQueue(size_t capacity) {
+  capacity = RoundUpToPowerOfTwo(capacity < 2 ? 2 : capacity);
+  cells_ = std::make_unique<Cell[]>(capacity);
+  mask_ = capacity - 1;
+  for (size_t i = 0; i < capacity; i++) {
+    cells_[i].sequence.store(i, std::memory_order_relaxed);
+  }
+}
+
+template <typename T>
+bool gs::MPMCQueue<T>::Push(const T& item) {
+  auto pos = enqueue_pos_.load(std::memory_order_relaxed);
+  Cell* cell;
+  while (true) {
+    cell = &cells_[pos & mask_];
+    auto sequence = cell->sequence.load(std::memory_order_acquire);
+    auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+    if (diff == 0) {
+      if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (diff < 0) {
+      return false;
+    } else {
+      pos = enqueue_pos_.load(std::memory_order_relaxed);
+    }
+  }
+  cell->data = item;
+  cell->sequence.store(pos + 1, std::memory_order_release);
+  return true;
+}
+
+template <typename T>
+bool gs::MPMCQueue<T>::Pop(T& item) {
+  auto pos = dequeue_pos_.load(std::memory_order_relaxed);
+  Cell* cell;
+  while (true) {
+    cell = &cells_[pos & mask_];
+    auto sequence = cell->sequence.load(std::memory_order_acquire);
+    auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+    if (diff == 0) {
+      if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (diff < 0) {
+      return false;
+    } else {
+      pos = dequeue_pos_.load(std::memory_order_relaxed);
+    }
+  }
+  item = cell->data;
+  cell->sequence.store(pos + mask_ + 1, std::memory_order_release);
+  return true;
+}
+
+template <typename T>
+bool gs::MPMCQueue<T>::Empty() const {
+  return dequeue_pos_.load(std::memory_order_acquire) >= enqueue_pos_.load(std::memory_order_acquire);
+}
+
+template <typename T>
+gs::WorkStealingDeque<T>::WorkStealingDeque(size_t capacity) {
+  capacity = RoundUpToPowerOfTwo(capacity < 2 ? 2 : capacity);
+  buffer_ = std::make_unique<std::atomic<T>[]>(capacity);
+  mask_ = static_cast<int64_t>(capacity) - 1;
+}
+
+template <typename T>
+bool gs::WorkStealingDeque<T>::Push(const T& item) {
+  auto bottom = bottom_.load(std::memory_order_relaxed);
+  auto top = top_.load(std::memory_order_acquire);
+  if (bottom - top > mask_) {
+    return false;
+  }
+  buffer_[bottom & mask_].store(item, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  bottom_.store(bottom + 1, std::memory_order_relaxed);
+  return true;
+}
+
+template <typename T>
+bool gs::WorkStealingDeque<T>::Pop(T& item) {
+  auto bottom = bottom_.load(std::memory_order_relaxed) - 1;
+  bottom_.store(bottom, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  auto top = top_.load(std::memory_order_relaxed);
+  if (top > bottom) {
+    bottom_.store(bottom + 1, std::memory_order_relaxed);
+    return false;
+  }
+
+  item = buffer_[bottom & mask_].load(std::memory_order_relaxed);
+  if (top == bottom) {
+    // the last item, race against thieves
+    auto success = top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    bottom_.store(bottom + 1, std::memory_order_relaxed);
+    return success;
+  }
+  return true;
+}
+
+template <typename T>
+bool gs::WorkStealingDeque<T>::Steal(T& item) {
+  auto top = top_.load(std::memory_order_acquire);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  auto bottom = bottom_.load(std::memory_order_acquire);
+  if (top >= bottom) {
+    return false;
+  }
+  item = buffer_[top & mask_].load(std::memory_order_relaxed);
+  return top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+}
+
+template <typename T>
+bool gs::WorkStealingDeque<T>::Empty() const {
+  return top_.load(std::memory_order_acquire) >= bottom_.load(std::memory_order_acquire);
+}
+
+inline void gs::PrioritySet::Push(int item) {
+  words_[item / 64].fetch_or(uint64_t(1) << (item % 64), std::memory_order_release);
+}
+
+inline bool gs::PrioritySet::Pop(int& item) {
+  for (size_t word = 0; word < words_.size(); word++) {
+    auto bits = words_[word].load(std::memory_order_relaxed);
+    while (bits != 0) {
+      auto bit = uint64_t(1) << __builtin_ctzll(bits);
+      // the lowest bit may be taken by another thread meanwhile, then retry with what is left
+      auto previous = words_[word].fetch_and(~bit, std::memory_order_acquire);
+      if (previous & bit) {
+        item = static_cast<int>(word * 64 + __builtin_ctzll(bit));
+        return true;
+      }
+      bits = previous & ~bit;
+    }
+  }
+  return false;
+}
+
+inline bool gs::PrioritySet::Empty() const {
+  for (auto& word : words_) {
+    if (word.load(std::memory_order_relaxed) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
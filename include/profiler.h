@@ -0,0 +1,133 @@
+/**
+ * Copyright 2026 by GallenShao, All Rights Reserved.
+ *
+ * profiler.h
+ *
+ *  Created on: 2026.10.17
+ *  Author: gallenshao
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace gs {
+
+#define PROFILER_BUFFER_SIZE 4096
+
+/**
+ * 帧性能分析器，功能：
+ *   1. Traverser记录每个System的开始、结束时间、运行线程以及在就绪队列中的等待时间
+ *   2. 每个线程写入各自的无锁环形缓冲区，SystemManager::Update结束时统一收集
+ *   3. 导出Chrome trace-event格式的JSON(chrome://tracing、Perfetto)，以及每个System最近若干帧的p50/p99统计
+ *
+ * Example:
+ *
+ * auto profiler = std::make_shared<gs::FrameProfiler>();
+ * manager->SetProfiler(profiler);
+ * manager->Update(entities);
+ * auto stats = profiler->GetStats<ASystem>();
+ *
+ * std::ofstream file("trace.json");
+ * profiler->WriteChromeTrace(file);
+ */
+class FrameProfiler {
+ public:
+  typedef int Family;
+
+  // timestamps are nanoseconds since the profiler was created
+  struct Event {
+    Family family;
+    int thread;
+    uint32_t frame;
+    int64_t ready;
+    int64_t start;
+    int64_t end;
+  };
+
+  // microseconds over the last `window` samples
+  struct Stats {
+    int samples = 0;
+    double p50 = 0;
+    double p99 = 0;
+    double wait_p50 = 0;
+    double wait_p99 = 0;
+  };
+
+  explicit FrameProfiler(int window = 120, size_t max_trace_events = 1 << 20);
+  ~FrameProfiler();
+
+  FrameProfiler(const FrameProfiler&) = delete;
+  FrameProfiler& operator=(const FrameProfiler&) = delete;
+
+  int64_t Now() const;
+
+  void BeginFrame();
+  // thread-safe, lock-free once the calling thread has its buffer
+  void Record(Family family, int64_t ready, int64_t start, int64_t end);
+  // move the events out of the per-thread buffers, call it when no system is running
+  void Collect();
+
+  void SetName(Family family, const std::string& name);
+
+  Stats GetStats(Family family) const;
+  template <typename T>
+  Stats GetStats() const {
+    return GetStats(T::family());
+  }
+
+  const std::vector<Event>& events() const { return events_; }
+  uint64_t dropped_count() const;
+  void WriteChromeTrace(std::ostream& stream) const;
+  void Clear();
+
+ private:
+  // single producer (the recording thread) single consumer (`Collect`)
+  class RingBuffer {
+   public:
+    explicit RingBuffer(int thread);
+    bool Push(const Event& event);
+    template <typename F>
+    void PopAll(F&& func);
+
+    const int thread;
+    const std::thread::id owner = std::this_thread::get_id();
+    std::atomic<uint64_t> dropped = {0};
+
+   private:
+    std::unique_ptr<Event[]> events_;
+    alignas(64) std::atomic<uint64_t> head_ = {0};
+    alignas(64) std::atomic<uint64_t> tail_ = {0};
+  };
+
+  struct Samples {
+    std::vector<int64_t> durations;
+    std::vector<int64_t> waits;
+    size_t next = 0;
+  };
+
+  RingBuffer& GetThreadBuffer();
+
+  const uint64_t id_;
+  const int window_;
+  const size_t max_trace_events_;
+  const std::chrono::steady_clock::time_point epoch_ = std::chrono::steady_clock::now();
+  std::atomic<uint32_t> frame_ = {0};
+
+  mutable std::mutex buffers_lock_;
+  std::vector<std::unique_ptr<RingBuffer>> buffers_;
+
+  std::vector<Event> events_;
+  std::vector<Samples> samples_;
+  std::vector<std::string> names_;
+};
+
+}  // namespace gs
@@ -0,0 +1,70 @@
+/**
+ * Copyright 2026 by GallenShao, All Rights Reserved.
+ *
+ * schedule.h
+ *
+ *  Created on: 2026.10.17
+ *  Author: gallenshao
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+namespace gs {
+
+class BaseSystem;
+
+/**
+ * 编译后的System依赖图，SystemManager冻结后只构建一次，每帧直接复用：
+ *   1. System按拓扑层级排序，family重映射为连续下标
+ *   2. 后继关系存放在连续数组中(CSR)，入度预先计算，每帧只需复制入度计数
+ *   3. 含有System::SyncPoint的层级之后插入同步点，把下标切分为若干段，后一段在前一段全部完成后才开始
+ */
+class FrameSchedule {
+ public:
+  typedef int Family;
+
+  void Build(const std::vector<std::shared_ptr<BaseSystem>>& systems);
+
+  int size() const { return static_cast<int>(families_.size()); }
+
+  int IndexOf(Family family) const { return family_to_index_[family]; }
+  Family FamilyOf(int index) const { return families_[index]; }
+
+  const int* SuccessorsBegin(int index) const { return successors_.data() + successor_offsets_[index]; }
+  const int* SuccessorsEnd(int index) const { return successors_.data() + successor_offsets_[index + 1]; }
+
+  int InDegree(int index) const { return in_degrees_[index]; }
+
+  // indices of level `level` are [level_offsets()[level], level_offsets()[level + 1])
+  int Level(int index) const { return levels_[index]; }
+  int level_count() const { return static_cast<int>(level_offsets_.size()) - 1; }
+  const std::vector<int>& level_offsets() const { return level_offsets_; }
+
+  // indices without dependencies, i.e. the first level
+  int root_count() const { return level_offsets_.size() > 1 ? level_offsets_[1] : 0; }
+
+  // indices of segment `segment` are [segment_offsets()[segment], segment_offsets()[segment + 1]),
+  // a sync point sits between every two segments
+  int Segment(int index) const { return segments_[index]; }
+  int segment_count() const { return static_cast<int>(segment_offsets_.size()) - 1; }
+  const std::vector<int>& segment_offsets() const { return segment_offsets_; }
+
+ private:
+  std::vector<int> family_to_index_;
+  std::vector<Family> families_;
+
+  std::vector<int> successor_offsets_;
+  std::vector<int> successors_;
+  std::vector<int> in_degrees_;
+
+  std::vector<int> levels_;
+  std::vector<int> level_offsets_;
+
+  std::vector<int> segments_;
+  std::vector<int> segment_offsets_;
+};
+
+}  // namespace gs
@@ -0,0 +1,71 @@
+/**
+ * Copyright 2026 by GallenShao, All Rights Reserved.
+ *
+ * snapshot.h
+ *
+ *  Created on: 2026.10.17
+ *  Author: gallenshao
+ */
+
+#pragma once
+
+#include "allocator.h"
+#include "entity.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace gs {
+
+#define SNAPSHOT_VERSION 4
+
+/**
+ * EntityManager的二进制快照，功能：
+ *   1. Chunk按内存布局原样写入文件，文件内按CHUNK_ALIGNMENT对齐，不逐实体序列化
+ *   2. 组件以稳定的名字(Component<T>::SnapshotName)记录，加载时映射到当前进程的family
+ *   3. Load以mmap映射文件(私有写时复制)，布局一致的Chunk直接引用映射内存，否则按列整体拷贝
+ *   4. 只支持可平凡拷贝(trivially copyable)的组件，包括SparseStorage组件
+ *
+ * | header | components | slot versions | free list | archetypes | sparse sets | padding | chunks |
+ *
+ * Example:
+ *
+ * gs::Snapshot::Save(world, "world.snapshot");
+ *
+ * // the components are registered first, e.g. by gs::ComponentList<Position, Velocity>::mask()
+ * gs::EntityManager restored;
+ * gs::Snapshot::Load(restored, "world.snapshot");
+ */
+class Snapshot {
+ public:
+  // return false if the file can not be written or a component is not trivially copyable
+  static bool Save(const EntityManager& manager, const std::string& path);
+
+  // `manager` must be empty. Return false if the file can not be mapped, its version or layout does not match,
+  // or one of its components is not registered in this process, `manager` is left empty then
+  static bool Load(EntityManager& manager, const std::string& path);
+};
+
+/**
+ * 把快照文件映射为Chunk内存的分配器：映射区域内的Chunk释放时忽略，映射随分配器一起解除，
+ * 其余请求转发给被包装的分配器
+ */
+class MappedChunkAllocator : public ChunkAllocator {
+ public:
+  MappedChunkAllocator(void* data, size_t size, std::shared_ptr<ChunkAllocator> allocator);
+  ~MappedChunkAllocator() override;
+
+  void* Allocate(size_t size) override;
+  void Deallocate(void* ptr, size_t size) override;
+
+  uint8_t* data() const { return data_; }
+  size_t size() const { return size_; }
+
+ private:
+  uint8_t* data_;
+  size_t size_;
+  std::shared_ptr<ChunkAllocator> allocator_;
+};
+
+}  // namespace gs
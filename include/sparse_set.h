@@ -0,0 +1,74 @@
+/**
+ * Copyright 2026 by GallenShao, All Rights Reserved.
+ *
+ * sparse_set.h
+ *
+ *  Created on: 2026.10.17
+ *  Author: gallenshao
+ */
+
+#pragma once
+
+#include "allocator.h"
+#include "component.h"
+#include "entity.h"
+#include <cstdint>
+#include <vector>
+
+namespace gs {
+
+/**
+ * 单个组件类型的稀疏集合存储，用于频繁增删的组件(见Component<T>::SparseStorage)：
+ *   1. 以实体槽位下标索引稀疏数组，得到组件在紧密数组中的位置，增删查均为O(1)
+ *   2. 增删组件不会使实体在Archetype之间移动，实体其余组件原地不动
+ *   3. 紧密数组按页存放，页内存来自ChunkAllocator，扩容时已有组件地址不变
+ *
+ * | sparse[entity index] | -> | entities[size] | pages of components |
+ */
+class SparseSet {
+ public:
+  // pages are allocated from `allocator`, which must outlive the set
+  SparseSet(ComponentBase::Family family, ChunkAllocator& allocator);
+  ~SparseSet();
+
+  SparseSet(const SparseSet&) = delete;
+  SparseSet& operator=(const SparseSet&) = delete;
+
+  ComponentBase::Family family() const { return family_; }
+  size_t size() const { return entities_.size(); }
+  const std::vector<Entity>& entities() const { return entities_; }
+
+  bool Has(Entity entity) const {
+    return entity.index() < sparse_.size() && sparse_[entity.index()] != INVALID_INDEX &&
+           entities_[sparse_[entity.index()]] == entity;
+  }
+
+  // component of `entity`, nullptr if it does not have one
+  void* Get(Entity entity) const { return Has(entity) ? At(sparse_[entity.index()]) : nullptr; }
+
+  // component at position `index` of the dense array, entities()[index] is its owner
+  void* At(size_t index) const {
+    return pages_[index / page_capacity_] + (index % page_capacity_) * info_.size;
+  }
+
+  // append uninitialized storage for `entity`, which must not have the component yet
+  void* Add(Entity entity);
+
+  // destroy the component of `entity` if any, the last one is relocated into the hole
+  void Remove(Entity entity);
+
+ private:
+  static constexpr uint32_t INVALID_INDEX = UINT32_MAX;
+
+  const ComponentBase::Family family_;
+  const ComponentBase::Info info_;
+  ChunkAllocator& allocator_;
+  size_t page_bytes_ = CHUNK_SIZE;
+  size_t page_capacity_ = 0;
+
+  std::vector<uint32_t> sparse_;
+  std::vector<Entity> entities_;
+  std::vector<uint8_t*> pages_;
+};
+
+}  // namespace gs
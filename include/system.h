@@ -9,22 +9,33 @@
 
 #pragma once
 
+#include "affinity.h"
+#include "command_buffer.h"
+#include "component.h"
 #include "entity.h"
+#include "lock_free_queue.h"
+#include "profiler.h"
+#include "schedule.h"
 #include "thread.h"
-#include <bitset>
+#include "wait_strategy.h"
+#include <atomic>
 #include <cassert>
+#include <condition_variable>
 #include <cstdint>
 #include <functional>
 #include <list>
 #include <memory>
 #include <mutex>
 #include <set>
+#include <string>
 #include <thread>
 #include <utility>
 #include <vector>
 
 #define GS_DEBUG true
 
+#define DEFAULT_MAX_CATCH_UP_STEPS 8
+
 #if !GS_DEBUG
 #define assert(e)
 #endif
@@ -34,13 +45,21 @@
  *   1. System支持多线程运行
  *   2. System支持绑定指定类型的Thread，Thread可自定义初始化、销毁函数
  *   3. 支持自定义System执行时依赖
+ *   4. 支持声明System读写的组件，访问冲突的System按注册顺序自动推导依赖，互不冲突的System可并行
+ *   5. System内部可将实体遍历按Chunk拆分，在Traverser的线程池中并行执行
+ *   6. 可选的帧性能分析，记录每个System的耗时、运行线程与等待时间，见FrameProfiler
+ *   7. System可通过每个线程独立的CommandBuffer延迟创建、销毁实体及增删组件，在同步点及每帧结束时统一执行
+ *   8. 每个线程拥有每帧重置的线性分配器(FrameArena)，内存块来自可替换的ChunkAllocator
+ *   9. 每个System以独立的Tick写入组件，配合LastRunTick与View::ChangedSince只处理上次运行后变化的Chunk
+ *   10. System或SystemGroup可指定固定的运行频率，Update(manager, dt)按累计时间补足步数，只调度到期的System
+ *   11. 可选的帧流水线，后一阶段的System读取上一帧发布的组件副本，与下一帧的前一阶段并行执行
+ *   12. 就绪的System可按其后续最长依赖链(关键路径)优先调度，链长可按历史帧实测耗时加权
  *
  * 关键对外类：SystemManager、SystemGroup、System、SystemThread
  */
 namespace gs {
 
-#define MAX_SYSTEM_COUNT 256
-
+class SystemManager;
 class SystemTraverser;
 class SystemGroup;
 class SystemGroupBuilder;
@@ -52,17 +71,71 @@ class BaseSystem : public std::enable_shared_from_this<BaseSystem> {
   virtual void Configure(EntityManager& manager) {}
   virtual void Update(EntityManager& manager) {}
 
+  // shown by FrameProfiler, the demangled type name by default
+  virtual std::string GetName();
+
  protected:
   static Family family_count_;
   virtual Family GetFamily() = 0;
 
+  // run job(0) ... job(count - 1) on the threads of the running traverser, return when all of them are done
+  void ParallelFor(int count, const std::function<void(int)>& job);
+
+  // View::ForEach / View::ForEachChunk with the chunks split across the threads of the running traverser
+  template <typename... Ts, typename F>
+  void ParallelForEach(View<Ts...> view, F&& func);
+  template <typename... Ts, typename F>
+  void ParallelForEachChunk(View<Ts...> view, F&& func);
+  // View::ForEachBatch with the chunks split across the threads of the running traverser, trivially copyable
+  // components only as well
+  template <int N, typename... Ts, typename F>
+  void ParallelForEachBatch(View<Ts...> view, F&& func);
+
+  // structural changes recorded here are played back at the next sync point, see System::SyncPoint
+  CommandBuffer& Commands();
+
+  // scratch memory of the calling thread, released at the start of the next Configure or Update
+  LinearArena& FrameArena();
+
+  // tick of the previous `Update` of this system, 0 before the first one. Every write made since then has a newer
+  // tick, including the ones of systems which ran after it in the previous frame. The order of a writer and a
+  // reader within a frame still comes from Access declarations or explicit dependencies.
+  //
+  // manager.View<const Position>().ChangedSince<Position>(LastRunTick()).ForEach(...);
+  Tick LastRunTick() const { return last_run_tick_; }
+
+  // seconds simulated by the running `Update`: 1 / rate for systems with a tick rate, otherwise the frame time
+  // passed to SystemManager::Update, see SystemGroupBuilder::WithTickRate
+  double DeltaTime() const { return delta_time_; }
+
  private:
-  std::bitset<MAX_SYSTEM_COUNT> dependencies_;
+  bool ConflictsWith(const BaseSystem& other) const;
+
+  SystemTraverser* traverser_ = nullptr;
+  SystemManager* manager_ = nullptr;
+  bool sync_point_ = false;
+  bool pipeline_boundary_ = false;
+  Tick last_run_tick_ = 0;
+
+  // 0 runs once per frame, see SystemManager::Update(EntityManager&, double)
+  double tick_rate_ = 0;
+  double accumulator_ = 0;
+  int pending_steps_ = 0;
+  double delta_time_ = 0;
+
+  std::set<Family> dependencies_;
   std::set<Family> next_;
   SystemThreadBase::Family initializer_family_ = DefaultThread::family();
 
+  // components read or written in `Update`, and the written ones, see System::Access
+  ComponentMask access_mask_;
+  ComponentMask write_mask_;
+
+  friend class SystemGroup;
+  friend class FrameSchedule;
   friend class SingleThreadTraverser;
   friend class MultiThreadTraverser;
+  friend class WorkStealingTraverser;
   friend class SystemManager;
   friend class SystemGroupBuilder;
   friend class SystemGroupBuilderItem;
@@ -76,10 +149,39 @@ class BaseSystem : public std::enable_shared_from_this<BaseSystem> {
  *     std::cout << "ASystem Update" << std::endl;
  *   }
  * };
+ *
+ * class MoveSystem : public gs::System<MoveSystem> {
+ *  public:
+ *   // components accessed in Update, const ones are read-only
+ *   typedef gs::ComponentList<Position, const Velocity> Access;
+ *
+ *   void Update(gs::EntityManager& manager) override {
+ *     ParallelForEach(manager.View<Position, const Velocity>(), [](Position& position, const Velocity& velocity) {
+ *       position.x += velocity.x;
+ *     });
+ *   }
+ * };
+ *
+ * class SpawnSystem : public gs::System<SpawnSystem> {
+ *  public:
+ *   // systems of later dependency levels see the entities spawned here
+ *   static constexpr bool SyncPoint = true;
+ *
+ *   void Update(gs::EntityManager& manager) override {
+ *     Commands().Assign<Position>(Commands().Create());
+ *   }
+ * };
  */
 template <typename T>
 class System : public BaseSystem {
  public:
+  typedef ComponentList<> Access;
+  // play back the command buffers once this system's dependency level is done,
+  // otherwise they are played back at the end of the frame
+  static constexpr bool SyncPoint = false;
+  // first system of the late pipeline stage, only used once SystemManager::EnablePipelining is called
+  static constexpr bool PipelineBoundary = false;
+
   static Family family();
   Family GetFamily() override;
 };
@@ -109,6 +211,9 @@ class SystemGroupBuilder {
   template <typename T>
   typename std::enable_if<std::is_base_of<SystemThread<T>, T>::value, SystemGroupBuilder>::type WithThread();
 
+  // run `rate` times per simulated second, systems of a nested group keep the rate they already have
+  SystemGroupBuilder WithTickRate(double rate);
+
  private:
   SystemGroupBuilder(SystemGroup* group, std::set<BaseSystem::Family>& current)
       : group_(group), current_(std::move(current)) {}
@@ -126,6 +231,9 @@ class SystemGroupBuilder {
  * group.AddSystem<ASystem>();
  * group.AddSystem<BSystem>();
  * group.AddSystem<CSystem>().WhichDependsOn<BSystem>();
+ *
+ * Systems whose System::Access conflict (one writes a component the other reads or writes) are
+ * ordered automatically by registration order: the one added later depends on the earlier one.
  */
 class SystemGroup {
  public:
@@ -135,9 +243,13 @@ class SystemGroup {
   SystemGroupBuilder AddSystemGroup(SystemGroup& group);
 
  protected:
+  bool Contains(BaseSystem::Family family) const;
+  void AddDependency(BaseSystem::Family family, BaseSystem::Family dependency_family);
+  bool Reachable(BaseSystem::Family from, BaseSystem::Family to) const;
+
   bool editable_ = true;
   std::vector<std::shared_ptr<BaseSystem>> all_systems_;
-  std::bitset<MAX_SYSTEM_COUNT> all_systems_mask_;
+  std::set<BaseSystem::Family> all_system_families_;
   std::set<BaseSystem::Family> start_node_families_;
 
   std::vector<ThreadCreator> thread_creator_;
@@ -147,6 +259,7 @@ class SystemGroup {
 
  private:
   SystemGroupBuilder AddSystem(BaseSystem::Family family, std::shared_ptr<BaseSystem> system);
+  void InferDependencies(const std::set<BaseSystem::Family>& families, const std::set<BaseSystem::Family>& candidates);
 };
 
 /**
@@ -170,6 +283,10 @@ class SystemGroup {
  * gs::EntityManager dummy;
  * manager->Configure(dummy);
  * manager->Update(dummy);
+
+ * // PhysicsSystem steps at 120 Hz whatever the frame rate, the other systems once per call
+ * manager->AddSystem<PhysicsSystem>().WithTickRate(120);
+ * manager->Update(dummy, 1.0 / 60);
  */
 class SystemManager : public SystemGroup, public std::enable_shared_from_this<SystemManager> {
  public:
@@ -177,31 +294,146 @@ class SystemManager : public SystemGroup, public std::enable_shared_from_this<Sy
   static typename std::enable_if<std::is_base_of<SystemTraverser, T>::value, std::shared_ptr<SystemManager>>::type
   MakeFromTraverser(Args&&... args);
 
+  SystemManager();
+
   template <typename T>
   typename std::enable_if<std::is_base_of<SystemThread<T>, T>::value, void>::type SetMaxThreadCount(int count);
   void SetMaxThreadCount(int count);
 
+  // pin the threads of T, see ThreadAffinity. Only affects threads started after this call, the threads of a family
+  // start when its first system runs. Pair it with a NodeLocalChunkAllocator to keep the chunks they create local
+  template <typename T>
+  typename std::enable_if<std::is_base_of<SystemThread<T>, T>::value, void>::type SetThreadAffinity(
+      const ThreadAffinity& affinity);
+  void SetThreadAffinity(const ThreadAffinity& affinity);
+
   void Configure(EntityManager& entityManager);
+  // run every system once, tick rates are ignored
   void Update(EntityManager& entityManager);
+  // advance the simulation by `dt` seconds: systems with a tick rate run as many fixed steps as their accumulated
+  // time allows, at most `SetMaxCatchUpSteps`, the others run once. Catch-up steps are separate passes over the
+  // schedule, each one only runs its due systems, and systems without a tick rate run in the last one
+  void Update(EntityManager& entityManager, double dt);
+  // the time beyond it is dropped, so that a long frame does not snowball
+  void SetMaxCatchUpSteps(int steps) { max_catch_up_steps_ = steps; }
+
+  // memory of the command buffers and frame arenas, only affects threads which run their first system after this call
+  void SetAllocator(std::shared_ptr<ChunkAllocator> allocator);
+
+  // record every system run by `Update`, pass nullptr to stop recording
+  void SetProfiler(std::shared_ptr<FrameProfiler> profiler);
+
+  // Pipelined frames. The systems marked with System::PipelineBoundary and all the systems depending on them form
+  // the late stage, which reads Published<Ts> copied at the end of the previous frame instead of waiting for this
+  // frame's early stage: their dependencies on early systems are dropped unless their Access conflict. Each
+  // `Update` then runs the early stage of frame N alongside the late stage of frame N - 1, e.g. the simulation
+  // next to the render thread. Late systems must declare Access to be kept apart from early writers.
+  // Call before the first Configure or Update.
+  template <typename... Ts>
+  void EnablePipelining();
+
+  // order in which ready systems are picked, also among the ones waiting for a busy SystemThread family:
+  //   LEVEL: by dependency level then registration order, the default
+  //   CRITICAL_PATH: by the number of systems in the longest chain depending on them, so that long chains start first
+  //   MEASURED_CRITICAL_PATH: the chains are weighted by the run time of each system averaged over the previous
+  //   frames, which costs two clock reads per system and a re-ranking per frame
+  enum Priority { LEVEL, CRITICAL_PATH, MEASURED_CRITICAL_PATH };
+  void SetPriority(Priority priority);
+  const std::shared_ptr<FrameProfiler>& profiler() const { return profiler_; }
 
   template <typename T>
   typename std::enable_if<std::is_base_of<System<T>, T>::value, std::shared_ptr<T>>::type Get();
 
  private:
+  void Compile();
   void Reset();
-  bool GetNext(std::shared_ptr<BaseSystem>& next);
+  // rank the systems, see `SetPriority`
+  void UpdatePriorities();
+  void PushRunnable(int index) { runnable_systems_->Push(rank_of_index_[index]); }
+  bool PopRunnable(int& index);
+  void RecordRunTime(int index, int64_t nanoseconds);
+  // drop the dependencies of the late pipeline stage on the early one, see `EnablePipelining`
+  void SplitPipelineStages();
+  template <typename T>
+  static void Publish(EntityManager& entities);
+  // one traversal of the schedule, systems which are not due are skipped by `GetNext`
+  void RunFrame(EntityManager& entityManager);
+  // `next` is nullptr if no system is runnable yet, return false once all systems are done
+  bool GetNext(BaseSystem*& next);
   void OnSystemFinished(BaseSystem::Family family);
-  void OnSystemTryAgainLater(BaseSystem::Family family);
   std::shared_ptr<BaseSystem> Get(BaseSystem::Family family);
 
-  std::mutex locker;
-  std::list<BaseSystem::Family> runnable_systems_;
-  std::bitset<MAX_SYSTEM_COUNT> system_finished_;
+  // built once by `Compile` when the manager is frozen
+  FrameSchedule schedule_;
+
+  // lock-free scheduling state indexed by the schedule, sized by `Compile` and reset by `Reset` before each traversal
+  // ranks of the runnable systems, the lowest one is run first
+  std::unique_ptr<PrioritySet> runnable_systems_;
+  std::vector<int> rank_of_index_;
+  std::vector<int> index_of_rank_;
+  // moving average in nanoseconds, written by the thread running the system
+  std::vector<double> run_times_;
+  Priority priority_ = LEVEL;
+  bool measure_run_times_ = false;
+  std::vector<std::atomic<int>> remaining_dependencies_;
+  std::atomic<int> finished_count_ = {0};
+  // whether the system runs in the current traversal, see `Update(EntityManager&, double)`
+  std::vector<uint8_t> due_;
+  int max_catch_up_steps_ = DEFAULT_MAX_CATCH_UP_STEPS;
+
+  // run at the end of every frame when pipelined, copy the components crossing the stage boundary
+  std::vector<void (*)(EntityManager&)> publishers_;
+  bool pipelined_ = false;
+
+  // counts down the systems of each segment, the last one plays back the command buffers
+  // and releases the next segment
+  std::vector<std::atomic<int>> segment_remaining_;
+
+  // state of every thread which ran a system of this manager, command buffers are played back in creation order
+  struct ThreadContext {
+    explicit ThreadContext(const std::shared_ptr<ChunkAllocator>& allocator)
+        : commands(allocator), frame_arena(allocator) {}
+
+    const std::thread::id owner = std::this_thread::get_id();
+    CommandBuffer commands;
+    LinearArena frame_arena;
+  };
+
+  ThreadContext& GetThreadContext();
+  // writes of the played back commands are stamped with `tick`
+  void PlaybackCommandBuffers(Tick tick);
+  void ResetFrameArenas();
+
+  // every frame owns `tick_stride_` ticks: the system at schedule index i writes at 2 * i + 2, the command buffers
+  // played back before it at 2 * i + 1, so that a system sees all writes made after its previous run
+  void BeginFrame();
+  void EndFrame();
+  Tick SystemTick(int index) const { return frame_ * tick_stride_ + 2 * index + 2; }
+  Tick PlaybackTick(int index) const { return frame_ * tick_stride_ + 2 * index + 1; }
+  // run `func` with the writes of the calling thread stamped by the tick of the system
+  template <typename F>
+  void RunSystem(BaseSystem& system, F&& func);
+
+  const uint64_t id_;
+  std::shared_ptr<ChunkAllocator> allocator_;
+  std::mutex thread_contexts_lock_;
+  std::vector<std::unique_ptr<ThreadContext>> thread_contexts_;
+  // valid during `Configure` and `Update`
+  EntityManager* entities_ = nullptr;
+  // counts the calls to `Configure` and `Update`, see `SystemTick`
+  Tick frame_ = 0;
+  Tick tick_stride_ = 0;
+
+  // time each system was pushed to `runnable_systems_`, only written while profiling
+  std::shared_ptr<FrameProfiler> profiler_;
+  std::vector<std::atomic<int64_t>> ready_times_;
 
   std::unique_ptr<SystemTraverser> system_traverser_;
 
+  friend class BaseSystem;
   friend class SingleThreadTraverser;
   friend class MultiThreadTraverser;
+  friend class WorkStealingTraverser;
 };
 
 class SystemTraverser {
@@ -211,8 +443,27 @@ class SystemTraverser {
   virtual void Traverse(std::function<void(std::shared_ptr<BaseSystem>&)> func) = 0;
 
   virtual void SetMaxThreadCount(SystemThreadBase::Family family, int count) {}
+  virtual void SetThreadAffinity(SystemThreadBase::Family family, const ThreadAffinity& affinity) {}
+
+  // run job(0) ... job(count - 1) and return when all of them are done, called by a running system
+  virtual void ParallelFor(int count, const std::function<void(int)>& job);
 
  protected:
+  // shared between the calling thread and the helper threads of `ParallelFor`
+  struct ParallelForState {
+    ParallelForState(int count, const std::function<void(int)>& job) : count(count), job(job) {}
+
+    // claim and run jobs until none is left, `job` is never touched once all jobs are claimed
+    void Work();
+    // wait until all claimed jobs are done
+    void Wait();
+
+    const int count;
+    const std::function<void(int)>& job;
+    std::atomic<int> next = {0};
+    std::atomic<int> completed = {0};
+  };
+
   std::weak_ptr<SystemManager> manager_;
 
   friend class SystemManager;
@@ -231,43 +482,219 @@ class SingleThreadTraverser : public SystemTraverser {
 
 class MultiThreadTraverser : public SystemTraverser {
  public:
-  MultiThreadTraverser();
+  // idle threads and the dispatcher wait following `wait_strategy`
+  explicit MultiThreadTraverser(const WaitStrategy& wait_strategy = WaitStrategy::Park());
   ~MultiThreadTraverser();
 
   void Traverse(std::function<void(std::shared_ptr<BaseSystem>&)> func) override;
 
   void SetMaxThreadCount(SystemThreadBase::Family family, int count) override;
+  void SetThreadAffinity(SystemThreadBase::Family family, const ThreadAffinity& affinity) override;
 
-  class Thread {
+  // helpers are posted to idle default threads
+  void ParallelFor(int count, const std::function<void(int)>& job) override;
+
+  // intrusive task record, posting one to a thread never allocates
+  class Task {
    public:
-    typedef std::function<void(void)> Task;
+    virtual ~Task() = default;
+    virtual void Run() = 0;
+  };
+
+  // systems whose threads were all busy when they became runnable, the threads of the family take the most urgent
+  // one, of the lowest rank (see SystemManager::SetPriority), once they are done with their task. `lock` also guards the threads
+  // going idle, so no task is left behind
+  struct PendingTasks {
+    bool Empty() const { return tasks.empty(); }
+    void Push(int rank, Task* task);
+    // nullptr if empty
+    Task* Pop();
+
+    std::mutex lock;
+    // min-heap of (rank, task), its capacity is reused across frames
+    std::vector<std::pair<int, Task*>> tasks;
+  };
 
-    Thread(std::shared_ptr<SystemThreadBase>& system_thread, MultiThreadTraverser* traverser)
-        : system_thread_(system_thread), traverser_(traverser) {}
+  class Thread {
+   public:
+    // the thread is pinned to `cpus` unless it is empty
+    Thread(std::shared_ptr<SystemThreadBase>& system_thread, MultiThreadTraverser* traverser, PendingTasks* pending,
+           const CpuSet& cpus)
+        : system_thread_(system_thread), traverser_(traverser), pending_(pending), cpus_(cpus) {}
     void StartLoop();
-    bool PostTask(const Task& task);
+    // return false if the thread is busy, `task` must stay alive until it has run
+    bool PostTask(Task* task);
     void StopLoop();
 
    private:
-    bool need_stop_ = false;
+    std::atomic<bool> need_stop_ = {false};
     std::shared_ptr<SystemThreadBase> system_thread_ = nullptr;
     std::shared_ptr<std::thread> thread_ = nullptr;
 
+    // written under `task_lock_`, polled without it while spinning
     std::mutex task_lock_;
-    Task current_task_ = nullptr;
+    std::atomic<Task*> current_task_ = {nullptr};
 
     std::mutex condition_lock_;
     std::condition_variable condition_ = {};
+    // waiting on `condition_`, posters only notify parked threads
+    std::atomic<bool> parked_ = {false};
 
     MultiThreadTraverser* traverser_;
+    PendingTasks* pending_;
+    CpuSet cpus_;
   };
 
  private:
-  std::vector<std::vector<std::shared_ptr<Thread>>> all_threads_;
+  // one per system, reused every frame
+  class SystemTask : public Task {
+   public:
+    void Run() override { traverser->Run(family); }
+    MultiThreadTraverser* traverser = nullptr;
+    BaseSystem::Family family = 0;
+  };
+
+  class ParallelForTask : public Task {
+   public:
+    explicit ParallelForTask(std::shared_ptr<ParallelForState> state) : state(std::move(state)) {}
+    void Run() override;
+    std::shared_ptr<ParallelForState> state;
+  };
 
+  void Run(BaseSystem::Family family);
+  // post the system to an idle thread of its family, otherwise queue it for them
+  void Dispatch(SystemManager& manager, BaseSystem& system);
+
+  std::vector<SystemTask> system_tasks_;
+
+  // valid during `Traverse`
+  SystemManager* traversing_manager_ = nullptr;
+  std::function<void(std::shared_ptr<BaseSystem>&)>* traversing_func_ = nullptr;
+
+  std::vector<std::vector<std::shared_ptr<Thread>>> all_threads_;
+  // indexed by thread family like `all_threads_`
+  std::vector<std::unique_ptr<PendingTasks>> pending_tasks_;
+  // indexed by thread family like `all_threads_`
+  std::vector<ThreadAffinity> affinities_;
+  // guards `all_threads_` against `ParallelFor` called on worker threads
+  std::mutex all_threads_lock_;
+
+  const WaitStrategy wait_strategy_;
   std::mutex wait_thread_lock_;
   std::condition_variable wait_thread_condition_ = {};
-  bool has_any_thread_just_finished_ = false;
+  std::atomic<bool> has_any_thread_just_finished_ = {false};
+  // threads only notify the dispatcher once it parked
+  std::atomic<bool> dispatcher_parked_ = {false};
+};
+
+/**
+ * 工作窃取线程池，功能：
+ *   1. 每个工作线程拥有无锁的双端队列，空闲时从同类型线程的队列中窃取System
+ *   2. 绑定了SystemThread的System只会在对应类型的线程上执行
+ *   3. 分发与完成通知均为无锁操作，只有线程空闲休眠时才会使用条件变量
+ *   4. 空闲时按WaitStrategy先自旋轮询再休眠，默认直接休眠
+ *
+ * 每种线程的数量在该类型第一次被使用时按SetMaxThreadCount创建，默认线程4个，自定义线程1个
+ */
+class WorkStealingTraverser : public SystemTraverser {
+ public:
+  // idle workers and the dispatcher wait following `wait_strategy`
+  explicit WorkStealingTraverser(const WaitStrategy& wait_strategy = WaitStrategy::Park());
+  ~WorkStealingTraverser();
+
+  void Traverse(std::function<void(std::shared_ptr<BaseSystem>&)> func) override;
+
+  void SetMaxThreadCount(SystemThreadBase::Family family, int count) override;
+  void SetThreadAffinity(SystemThreadBase::Family family, const ThreadAffinity& affinity) override;
+
+  // helpers are pushed to the deque of the calling worker, so that idle siblings can steal them
+  void ParallelFor(int count, const std::function<void(int)>& job) override;
+
+ private:
+  struct WorkerGroup;
+
+  class Job {
+   public:
+    virtual ~Job() = default;
+    virtual void Run() = 0;
+  };
+
+  class SystemJob : public Job {
+   public:
+    void Run() override { traverser->Run(family); }
+    WorkStealingTraverser* traverser = nullptr;
+    BaseSystem::Family family = 0;
+  };
+
+  class ParallelForJob : public Job {
+   public:
+    explicit ParallelForJob(std::shared_ptr<ParallelForState> state) : state(std::move(state)) {}
+    void Run() override;
+    std::shared_ptr<ParallelForState> state;
+  };
+
+  class Worker {
+   public:
+    // `capacity` bounds the jobs queued on this worker, it must hold every system of the group
+    Worker(std::shared_ptr<SystemThreadBase>& system_thread, WorkerGroup* group, int index, size_t capacity,
+           WorkStealingTraverser* traverser);
+    void StartLoop();
+    void Post(Job* job);
+    // owner only, return false if the deque is full
+    bool Push(Job* job);
+    void Wake();
+    void StopLoop();
+
+    bool IsSleeping() const { return sleeping_.load(); }
+
+   private:
+    bool HasWork() const;
+    bool Acquire(Job*& job);
+
+    std::atomic<bool> need_stop_ = {false};
+    std::atomic<bool> sleeping_ = {false};
+    std::shared_ptr<SystemThreadBase> system_thread_ = nullptr;
+    std::shared_ptr<std::thread> thread_ = nullptr;
+
+    WorkStealingDeque<Job*> deque_;
+    MPMCQueue<Job*> inbox_;
+
+    std::mutex condition_lock_;
+    std::condition_variable condition_ = {};
+
+    WorkerGroup* group_;
+    int index_;
+    WorkStealingTraverser* traverser_;
+
+    friend class WorkStealingTraverser;
+  };
+
+  struct WorkerGroup {
+    int max_count = 0;
+    ThreadAffinity affinity;
+    int next = 0;
+    std::vector<std::unique_ptr<Worker>> workers;
+  };
+
+  WorkerGroup& GetGroup(SystemThreadBase::Family family);
+  void Dispatch(SystemManager& manager, BaseSystem& system);
+  void Run(BaseSystem::Family family);
+
+  std::vector<std::unique_ptr<WorkerGroup>> groups_;
+  std::vector<SystemJob> system_jobs_;
+
+  static thread_local Worker* current_worker_;
+
+  // valid during `Traverse`
+  SystemManager* traversing_manager_ = nullptr;
+  std::function<void(std::shared_ptr<BaseSystem>&)>* traversing_func_ = nullptr;
+
+  const WaitStrategy wait_strategy_;
+  std::atomic<int> pending_ = {0};
+  std::atomic<uint64_t> finished_epoch_ = {0};
+  std::atomic<bool> dispatcher_sleeping_ = {false};
+  std::mutex dispatcher_lock_;
+  std::condition_variable dispatcher_condition_ = {};
 };
 
 }  // namespace gs
@@ -9,7 +9,11 @@
 
 #pragma once
 
+#include "command_buffer.hpp"
+#include "component.hpp"
+#include "lock_free_queue.hpp"
 #include "system.h"
+#include "view.hpp"
 
 template <typename T>
 gs::BaseSystem::Family gs::System<T>::family() {
@@ -25,7 +29,12 @@ gs::BaseSystem::Family gs::System<T>::GetFamily() {
 template <typename T>
 typename std::enable_if<std::is_base_of<gs::System<T>, T>::value, gs::SystemGroupBuilder>::type
 gs::SystemGroup::AddSystem() {
-  return AddSystem(T::family(), std::move(std::make_shared<T>()));
+  auto system = std::make_shared<T>();
+  system->access_mask_ = T::Access::mask();
+  system->write_mask_ = T::Access::write_mask();
+  system->sync_point_ = T::SyncPoint;
+  system->pipeline_boundary_ = T::PipelineBoundary;
+  return AddSystem(T::family(), std::move(system));
 }
 
 template <typename T>
@@ -61,15 +70,11 @@ template <typename T>
 typename std::enable_if<std::is_base_of<gs::System<T>, T>::value, gs::SystemGroupBuilderItem>::type
 gs::SystemGroupBuilderItem::And() {
   auto dependency_family = T::family();
-  assert(group_->all_systems_mask_.test(dependency_family));
+  assert(group_->Contains(dependency_family));
   assert(current_.find(dependency_family) == current_.end());
 
-  auto dependency_system = group_->all_systems_[dependency_family];
   for (auto& family : current_) {
-    auto system = group_->all_systems_[family];
-    system->dependencies_[dependency_family] = true;
-    group_->start_node_families_.erase(family);
-    dependency_system->next_.insert(family);
+    group_->AddDependency(family, dependency_family);
   }
 
   return *this;
@@ -96,8 +101,88 @@ gs::SystemManager::SetMaxThreadCount(int count) {
   system_traverser_->SetMaxThreadCount(T::family(), count);
 }
 
+template <typename T>
+typename std::enable_if<std::is_base_of<gs::SystemThread<T>, T>::value, void>::type
+gs::SystemManager::SetThreadAffinity(const ThreadAffinity& affinity) {
+  system_traverser_->SetThreadAffinity(T::family(), affinity);
+}
+
+template <typename... Ts>
+void gs::SystemManager::EnablePipelining() {
+  static_assert(!(Ts::SparseStorage || ...), "sparse components can not be published");
+  assert(editable_);
+  pipelined_ = true;
+  (publishers_.push_back(&SystemManager::Publish<Ts>), ...);
+}
+
+template <typename T>
+void gs::SystemManager::Publish(EntityManager& entities) {
+  auto family = T::family();
+  auto published = Published<T>::family();
+
+  // entities which gained or lost T since the last frame, collected first as assigning moves them
+  std::vector<Entity> added;
+  std::vector<Entity> removed;
+  for (auto& archetype : entities.archetypes()) {
+    if (archetype->Has(family) == archetype->Has(published)) {
+      continue;
+    }
+    auto& target = archetype->Has(family) ? added : removed;
+    for (auto& chunk : archetype->chunks()) {
+      auto begin = archetype->Entities(chunk);
+      target.insert(target.end(), begin, begin + chunk.size);
+    }
+  }
+  for (auto& entity : added) {
+    entities.Assign<Published<T>>(entity);
+  }
+  for (auto& entity : removed) {
+    entities.Remove<Published<T>>(entity);
+  }
+
+  entities.View<const T, Published<T>>().ForEachChunk(
+      [](int size, const Entity*, const T* values, Published<T>* copies) {
+        for (int i = 0; i < size; i++) {
+          copies[i].value = values[i];
+        }
+      });
+}
+
 template <typename T>
 typename std::enable_if<std::is_base_of<gs::System<T>, T>::value, std::shared_ptr<T>>::type
 gs::SystemManager::Get() {
-  return std::static_pointer_cast<T>(Get(all_systems_[T::family()]));
+  return std::static_pointer_cast<T>(Get(T::family()));
+}
+
+template <typename... Ts, typename F>
+void gs::BaseSystem::ParallelForEach(View<Ts...> view, F&& func) {
+  typedef typename View<Ts...>::ChunkRef ChunkRef;
+  auto count = view.ChunkCount();
+  auto chunks = static_cast<ChunkRef*>(FrameArena().Allocate(sizeof(ChunkRef) * count, alignof(ChunkRef)));
+  view.CollectChunks(chunks);
+  ParallelFor(static_cast<int>(count), [chunks, &func](int index) {
+    View<Ts...>::RunEach(chunks[index], func);
+  });
+}
+
+template <typename... Ts, typename F>
+void gs::BaseSystem::ParallelForEachChunk(View<Ts...> view, F&& func) {
+  typedef typename View<Ts...>::ChunkRef ChunkRef;
+  auto count = view.ChunkCount();
+  auto chunks = static_cast<ChunkRef*>(FrameArena().Allocate(sizeof(ChunkRef) * count, alignof(ChunkRef)));
+  view.CollectChunks(chunks);
+  ParallelFor(static_cast<int>(count), [chunks, &func](int index) {
+    View<Ts...>::RunChunk(chunks[index], func);
+  });
+}
+
+template <int N, typename... Ts, typename F>
+void gs::BaseSystem::ParallelForEachBatch(View<Ts...> view, F&& func) {
+  typedef typename View<Ts...>::ChunkRef ChunkRef;
+  auto count = view.ChunkCount();
+  auto chunks = static_cast<ChunkRef*>(FrameArena().Allocate(sizeof(ChunkRef) * count, alignof(ChunkRef)));
+  view.CollectChunks(chunks);
+  ParallelFor(static_cast<int>(count), [chunks, &func](int index) {
+    View<Ts...>::template RunBatch<N>(chunks[index], func);
+  });
 }
@@ -0,0 +1,64 @@
+/**
+ * Copyright 2026 by GallenShao, All Rights Reserved.
+ *
+ * thread_cache.h
+ *
+ *  Created on: 2026.10.17
+ *  Author: gallenshao
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace gs {
+
+/**
+ * 每个线程记住最近一次使用的T，用于跳过按线程查找T时的加锁：
+ *   1. 拥有者(如FrameProfiler)以NewOwner分配的id标识，不使用地址，
+ *      已销毁的拥有者以及之后分配在同一地址上的新对象都不会被误匹配
+ *   2. 每个线程只缓存一项，同一线程交替使用多个拥有者时退化为各自的加锁查找
+ *
+ * Example:
+ *
+ * auto buffer = gs::ThreadLocalCache<Buffer>::Get(id_);
+ * if (buffer == nullptr) {
+ *   buffer = FindOrCreateLocked();
+ *   gs::ThreadLocalCache<Buffer>::Set(id_, buffer);
+ * }
+ */
+template <typename T>
+class ThreadLocalCache {
+ public:
+  // unique among the owners of T, never 0
+  static uint64_t NewOwner() {
+    static std::atomic<uint64_t> count = {0};
+    return ++count;
+  }
+
+  // the value set by `owner` on this thread, nullptr if another owner was used since
+  static T* Get(uint64_t owner) {
+    auto& entry = Entry();
+    return entry.owner == owner ? entry.value : nullptr;
+  }
+
+  static void Set(uint64_t owner, T* value) {
+    auto& entry = Entry();
+    entry.owner = owner;
+    entry.value = value;
+  }
+
+ private:
+  struct Item {
+    uint64_t owner = 0;
+    T* value = nullptr;
+  };
+
+  static Item& Entry() {
+    static thread_local Item item;
+    return item;
+  }
+};
+
+}  // namespace gs
@@ -0,0 +1,112 @@
+/**
+ * Copyright 2026 by GallenShao, All Rights Reserved.
+ *
+ * view.h
+ *
+ *  Created on: 2026.10.17
+ *  Author: gallenshao
+ */
+
+#pragma once
+
+#include "component.h"
+#include "entity.h"
+
+namespace gs {
+
+/**
+ * 遍历同时拥有组件Ts...的所有实体，功能：
+ *   1. 组件签名由Ts...在编译期确定，匹配的Archetype整块遍历，循环内没有虚函数调用和逐实体判断
+ *   2. const修饰的组件为只读访问，见ComponentList::write_mask()，非const的列在遍历时记录写入Tick
+ *   3. ChangedSince只遍历指定组件在某个Tick之后被写过的Chunk，用于增量处理
+ *   4. ForEachBatch按固定N行一批遍历，最后一批越过实体末尾的行位于Chunk的填充区，SIMD内核无需处理尾部
+ *
+ * Example:
+ *
+ * manager.View<Position, const Velocity>().ForEach([](Position& position, const Velocity& velocity) {
+ *   position.x += velocity.x;
+ * });
+ *
+ * manager.View<Position, const Velocity>().ForEachChunk(
+ *     [](int size, const gs::Entity* entities, Position* positions, const Velocity* velocities) {
+ *       for (int i = 0; i < size; i++) {
+ *         positions[i].x += velocities[i].x;
+ *       }
+ *     });
+ *
+ * // 8 rows of 8 bytes fill a 64 byte aligned line, lanes past `size` are padding
+ * manager.View<Position, const Velocity>().ForEachBatch<8>(
+ *     [](int size, const gs::Entity* entities, Position* positions, const Velocity* velocities) {
+ *       for (int i = 0; i < 8; i++) {
+ *         positions[i].x += velocities[i].x;
+ *       }
+ *     });
+ *
+ * // in a System, only the chunks whose Position changed since its previous Update
+ * manager.View<const Position>().ChangedSince<Position>(LastRunTick()).ForEach([](const Position& position) {});
+ */
+template <typename... Ts>
+class View {
+ public:
+  typedef ComponentList<Ts...> Components;
+  static_assert(!(std::remove_const<Ts>::type::SparseStorage || ...),
+                "sparse components are not stored in chunks, use EntityManager::ForEachSparse");
+
+  // func(Ts&...) or func(gs::Entity, Ts&...)
+  template <typename F>
+  void ForEach(F&& func);
+
+  // func(int size, const gs::Entity* entities, Ts*... columns)
+  template <typename F>
+  void ForEachChunk(F&& func);
+
+  // func(int size, const gs::Entity* entities, Ts*... columns) for every N rows of a chunk, `size` is at most N.
+  // The N rows of each column can be read and written, rows past `size` are raw storage of no object, holding
+  // unspecified values which are discarded. Hence only trivially copyable components can be batched. Columns start
+  // CHUNK_ALIGNMENT aligned, so do the batches if N * sizeof(T) is a multiple of it
+  template <int N, typename F>
+  void ForEachBatch(F&& func);
+
+  size_t Size() const;
+
+  // only visit the chunks where any of Us... was written after `tick`, the chunk is the unit:
+  // unchanged entities of a changed chunk are visited as well
+  template <typename... Us>
+  View ChangedSince(Tick tick) const;
+
+  // a matching chunk, used to split the iteration into jobs, see BaseSystem::ParallelForEach
+  struct ChunkRef {
+    const Archetype* archetype;
+    const Chunk* chunk;
+    // stamped on the non-const columns by `RunChunk`
+    Tick tick;
+  };
+  size_t ChunkCount() const;
+  // `chunks` must have room for `ChunkCount()` refs
+  void CollectChunks(ChunkRef* chunks) const;
+
+  // run the func of `ForEachChunk`, `ForEach` or `ForEachBatch` on a single chunk
+  template <typename F>
+  static void RunChunk(const ChunkRef& ref, F&& func);
+  template <typename F>
+  static void RunEach(const ChunkRef& ref, F&& func);
+  template <int N, typename F>
+  static void RunBatch(const ChunkRef& ref, F&& func);
+
+ private:
+  explicit View(EntityManager& manager) : manager_(manager) {}
+
+  bool Match(const Archetype& archetype) const;
+  bool Changed(const Archetype& archetype, const Chunk& chunk) const;
+  // visit(const ChunkRef&) for every matching and changed chunk
+  template <typename F>
+  void VisitChunks(F&& visit) const;
+
+  EntityManager& manager_;
+  ComponentMask changed_mask_;
+  Tick changed_since_ = 0;
+
+  friend class EntityManager;
+};
+
+}  // namespace gs
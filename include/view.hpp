@@ -0,0 +1,141 @@
+/**
+ * Copyright 2026 by GallenShao, All Rights Reserved.
+ *
+ * view.hpp
+ *
+ *  Created on: 2026.10.17
+ *  Author: gallenshao
+ */
+
+#pragma once
+
+#include "entity.hpp"
+#include "view.h"
+#include <algorithm>
+#include <type_traits>
+
+template <typename... Ts>
+gs::View<Ts...> gs::EntityManager::View() {
+  return gs::View<Ts...>(*this);
+}
+
+template <typename... Ts>
+bool gs::View<Ts...>::Match(const Archetype& archetype) const {
+  auto mask = Components::mask() | changed_mask_;
+  return archetype.size() > 0 && (archetype.mask() & mask) == mask;
+}
+
+template <typename... Ts>
+bool gs::View<Ts...>::Changed(const Archetype& archetype, const Chunk& chunk) const {
+  if (changed_mask_.none()) {
+    return true;
+  }
+  for (auto family : archetype.families()) {
+    if (changed_mask_.test(family) && archetype.ColumnTick(chunk, family) > changed_since_) {
+      return true;
+    }
+  }
+  return false;
+}
+
+template <typename... Ts>
+template <typename F>
+void gs::View<Ts...>::VisitChunks(F&& visit) const {
+  auto tick = manager_.WriteTick();
+  for (auto& archetype : manager_.archetypes()) {
+    if (!Match(*archetype)) {
+      continue;
+    }
+    for (auto& chunk : archetype->chunks()) {
+      if (Changed(*archetype, chunk)) {
+        visit(ChunkRef{archetype.get(), &chunk, tick});
+      }
+    }
+  }
+}
+
+template <typename... Ts>
+template <typename... Us>
+gs::View<Ts...> gs::View<Ts...>::ChangedSince(Tick tick) const {
+  auto view = *this;
+  view.changed_mask_ = ComponentList<Us...>::mask();
+  view.changed_since_ = tick;
+  return view;
+}
+
+template <typename... Ts>
+template <typename F>
+void gs::View<Ts...>::ForEachChunk(F&& func) {
+  VisitChunks([&func](const ChunkRef& ref) { RunChunk(ref, func); });
+}
+
+template <typename... Ts>
+template <typename F>
+void gs::View<Ts...>::ForEach(F&& func) {
+  VisitChunks([&func](const ChunkRef& ref) { RunEach(ref, func); });
+}
+
+template <typename... Ts>
+template <int N, typename F>
+void gs::View<Ts...>::ForEachBatch(F&& func) {
+  VisitChunks([&func](const ChunkRef& ref) { RunBatch<N>(ref, func); });
+}
+
+template <typename... Ts>
+template <typename F>
+void gs::View<Ts...>::RunChunk(const ChunkRef& ref, F&& func) {
+  auto& chunk = *ref.chunk;
+  ((std::is_const<Ts>::value ? void()
+                             : ref.archetype->MarkWritten(chunk, std::remove_const<Ts>::type::family(), ref.tick)),
+   ...);
+  func(chunk.size, static_cast<const Entity*>(ref.archetype->Entities(chunk)),
+       static_cast<Ts*>(ref.archetype->Column(chunk, std::remove_const<Ts>::type::family()))...);
+}
+
+template <typename... Ts>
+template <typename F>
+void gs::View<Ts...>::RunEach(const ChunkRef& ref, F&& func) {
+  RunChunk(ref, [&func](int size, const Entity* entities, Ts*... columns) {
+    for (int i = 0; i < size; i++) {
+      if constexpr (std::is_invocable<F, Entity, Ts&...>::value) {
+        func(entities[i], columns[i]...);
+      } else {
+        func(columns[i]...);
+      }
+    }
+  });
+}
+
+template <typename... Ts>
+template <int N, typename F>
+void gs::View<Ts...>::RunBatch(const ChunkRef& ref, F&& func) {
+  // chunk capacities are multiples of MAX_BATCH_SIZE or padded to it, a batch never runs past the columns
+  static_assert(N > 0 && MAX_BATCH_SIZE % N == 0, "the batch size must divide MAX_BATCH_SIZE");
+  // the padding rows are never constructed, touching them is only defined for trivially copyable types
+  static_assert((std::is_trivially_copyable<std::remove_const_t<Ts>>::value && ...),
+                "only trivially copyable components can be batched");
+  RunChunk(ref, [&func](int size, const Entity* entities, Ts*... columns) {
+    for (int i = 0; i < size; i += N) {
+      func(std::min(N, size - i), entities + i, columns + i...);
+    }
+  });
+}
+
+template <typename... Ts>
+size_t gs::View<Ts...>::ChunkCount() const {
+  size_t count = 0;
+  VisitChunks([&count](const ChunkRef& ref) { count++; });
+  return count;
+}
+
+template <typename... Ts>
+void gs::View<Ts...>::CollectChunks(ChunkRef* chunks) const {
+  VisitChunks([&chunks](const ChunkRef& ref) { *chunks++ = ref; });
+}
+
+template <typename... Ts>
+size_t gs::View<Ts...>::Size() const {
+  size_t size = 0;
+  VisitChunks([&size](const ChunkRef& ref) { size += ref.chunk->size; });
+  return size;
+}
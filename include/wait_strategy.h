@@ -0,0 +1,64 @@
+/**
+ * Copyright 2026 by GallenShao, All Rights Reserved.
+ *
+ * wait_strategy.h
+ *
+ *  Created on: 2026.10.17
+ *  Author: gallenshao
+ */
+
+#pragma once
+
+#define DEFAULT_SPIN_COUNT 4096
+#define DEFAULT_YIELD_COUNT 64
+// an adaptive spin never shrinks below this many polls
+#define MIN_SPIN_COUNT 64
+
+namespace gs {
+
+/**
+ * 空闲线程等待新任务的策略，按Traverser选择：
+ *   1. 先执行spin_count次带pause指令的轮询，再执行yield_count次让出时间片的轮询，仍未等到才休眠在条件变量上
+ *   2. 轮询期间到达的任务无需futex系统调用与上下文切换即可开始，代价是线程空闲时占用CPU
+ *   3. 唤醒方只在对方已经休眠时才通知条件变量
+ *
+ * Example:
+ *
+ * // microsecond handoffs for short systems, idle workers burn CPU for a while before parking
+ * auto manager = gs::SystemManager::MakeFromTraverser<gs::MultiThreadTraverser>(gs::WaitStrategy::Spin());
+ */
+struct WaitStrategy {
+  int spin_count = 0;
+  int yield_count = 0;
+
+  // park right away, idle threads use no CPU
+  static WaitStrategy Park() { return WaitStrategy(); }
+  static WaitStrategy Spin(int spin_count = DEFAULT_SPIN_COUNT, int yield_count = DEFAULT_YIELD_COUNT) {
+    WaitStrategy strategy;
+    strategy.spin_count = spin_count;
+    strategy.yield_count = yield_count;
+    return strategy;
+  }
+};
+
+// hint the CPU that the caller is busy waiting
+inline void CpuRelax();
+
+/**
+ * 单个等待线程的轮询状态：轮询等到时恢复完整的自旋次数，休眠过后自旋次数减半，
+ * 长时间空闲的线程因此少浪费CPU，繁忙时又能保持快速交接
+ */
+class SpinWaiter {
+ public:
+  explicit SpinWaiter(const WaitStrategy& strategy) : strategy_(strategy), spin_budget_(strategy.spin_count) {}
+
+  // poll `ready()` following the strategy, return false if the caller should park
+  template <typename F>
+  bool Poll(F&& ready);
+
+ private:
+  const WaitStrategy strategy_;
+  int spin_budget_;
+};
+
+}  // namespace gs
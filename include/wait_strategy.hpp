@@ -0,0 +1,46 @@
+/**
+ * Copyright 2026 by GallenShao, All Rights Reserved.
+ *
+ * wait_strategy.hpp
+ *
+ *  Created on: 2026.10.17
+ *  Author: gallenshao
+ */
+
+#pragma once
+
+#include "wait_strategy.h"
+#include <algorithm>
+#include <thread>
+
+inline void gs::CpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+  asm volatile("yield");
+#endif
+}
+
+template <typename F>
+bool gs::SpinWaiter::Poll(F&& ready) {
+  for (int i = 0; i < spin_budget_; i++) {
+    if (ready()) {
+      spin_budget_ = strategy_.spin_count;
+      return true;
+    }
+    CpuRelax();
+  }
+  for (int i = 0; i < strategy_.yield_count; i++) {
+    if (ready()) {
+      spin_budget_ = strategy_.spin_count;
+      return true;
+    }
+    std::this_thread::yield();
+  }
+  if (ready()) {
+    spin_budget_ = strategy_.spin_count;
+    return true;
+  }
+  spin_budget_ = std::max(spin_budget_ / 2, std::min(strategy_.spin_count, MIN_SPIN_COUNT));
+  return false;
+}
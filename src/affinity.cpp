@@ -0,0 +1,187 @@
+/**
+ * Copyright 2026 by GallenShao, All Rights Reserved.
+ *
+ * affinity.cpp
+ *
+ *  Created on: 2026.10.17
+ *  Author: gallenshao
+ */
+
+#include "affinity.h"
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace gs {
+
+namespace {
+
+// parse a kernel id list such as "0-3,8,10-11", used for both CPUs and NUMA nodes
+CpuSet ParseIdList(const std::string& list) {
+  CpuSet cpus;
+  std::stringstream stream(list);
+  std::string range;
+  while (std::getline(stream, range, ',')) {
+    if (range.empty() || range == "\n") {
+      continue;
+    }
+    auto dash = range.find('-');
+    auto first = std::stoi(range.substr(0, dash));
+    auto last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+    for (int cpu = first; cpu <= last && cpu < MAX_CPU_COUNT; cpu++) {
+      cpus.set(cpu);
+    }
+  }
+  return cpus;
+}
+
+}  // namespace
+
+ThreadAffinity ThreadAffinity::Node(int node) {
+  ThreadAffinity affinity;
+  affinity.nodes.push_back(node);
+  return affinity;
+}
+
+ThreadAffinity ThreadAffinity::Cpus(const std::vector<int>& cpus) {
+  ThreadAffinity affinity;
+  for (auto cpu : cpus) {
+    affinity.cpus.set(cpu);
+  }
+  return affinity;
+}
+
+CpuSet ThreadAffinity::Resolve(int index) const {
+  auto result = cpus;
+  for (auto node : nodes) {
+    result |= Affinity::NodeCpus(node);
+  }
+  if (!one_cpu_per_thread || result.none()) {
+    return result;
+  }
+  // the index-th set bit, wrapping around
+  auto target = index % static_cast<int>(result.count());
+  for (int cpu = 0; cpu < MAX_CPU_COUNT; cpu++) {
+    if (result.test(cpu) && target-- == 0) {
+      CpuSet single;
+      single.set(cpu);
+      return single;
+    }
+  }
+  return result;
+}
+
+int Affinity::CpuCount() {
+  auto count = static_cast<int>(std::thread::hardware_concurrency());
+  return count > 0 ? count : 1;
+}
+
+int Affinity::NodeCount() {
+  return static_cast<int>(Nodes().size());
+}
+
+std::vector<int> Affinity::Nodes() {
+  // node ids may have gaps, e.g. with memory-less nodes or nodes taken offline
+  std::ifstream file("/sys/devices/system/node/online");
+  std::string list;
+  std::vector<int> nodes;
+  if (file && std::getline(file, list)) {
+    auto ids = ParseIdList(list);
+    for (int node = 0; node < MAX_CPU_COUNT; node++) {
+      if (ids.test(node)) {
+        nodes.push_back(node);
+      }
+    }
+  }
+  if (nodes.empty()) {
+    nodes.push_back(0);
+  }
+  return nodes;
+}
+
+CpuSet Affinity::NodeCpus(int node) {
+  std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+  std::string list;
+  if (file && std::getline(file, list)) {
+    return ParseIdList(list);
+  }
+  CpuSet cpus;
+  if (node == 0) {
+    for (int cpu = 0; cpu < CpuCount() && cpu < MAX_CPU_COUNT; cpu++) {
+      cpus.set(cpu);
+    }
+  }
+  return cpus;
+}
+
+int Affinity::CurrentNode() {
+#ifdef __linux__
+  unsigned cpu = 0;
+  unsigned node = 0;
+  if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0) {
+    return static_cast<int>(node);
+  }
+#endif
+  return 0;
+}
+
+bool Affinity::PinCurrentThread(const CpuSet& cpus) {
+#ifdef __linux__
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (int cpu = 0; cpu < MAX_CPU_COUNT && cpu < CPU_SETSIZE; cpu++) {
+    if (cpus.test(cpu)) {
+      CPU_SET(cpu, &set);
+    }
+  }
+  return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+  return false;
+#endif
+}
+
+CpuSet Affinity::CurrentThreadCpus() {
+  CpuSet cpus;
+#ifdef __linux__
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (pthread_getaffinity_np(pthread_self(), sizeof(set), &set) == 0) {
+    for (int cpu = 0; cpu < MAX_CPU_COUNT && cpu < CPU_SETSIZE; cpu++) {
+      if (CPU_ISSET(cpu, &set)) {
+        cpus.set(cpu);
+      }
+    }
+    return cpus;
+  }
+#endif
+  for (int cpu = 0; cpu < CpuCount() && cpu < MAX_CPU_COUNT; cpu++) {
+    cpus.set(cpu);
+  }
+  return cpus;
+}
+
+bool Affinity::BindMemory(void* ptr, size_t size, int node) {
+#if defined(__linux__) && defined(SYS_mbind)
+  // MPOL_PREFERRED from <numaif.h>, which is only shipped with libnuma
+  const int MPOL_PREFERRED_POLICY = 1;
+  const size_t mask_bits = 8 * sizeof(unsigned long);
+  if (node < 0 || node >= MAX_CPU_COUNT) {
+    return false;
+  }
+  std::vector<unsigned long> mask(node / mask_bits + 1, 0);
+  mask[node / mask_bits] |= 1UL << (node % mask_bits);
+  return syscall(SYS_mbind, ptr, size, MPOL_PREFERRED_POLICY, mask.data(), mask.size() * mask_bits + 1, 0) == 0;
+#else
+  return false;
+#endif
+}
+
+}  // namespace gs
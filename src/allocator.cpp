@@ -0,0 +1,148 @@
+/**
+ * Copyright 2026 by GallenShao, All Rights Reserved.
+ *
+ * allocator.cpp
+ *
+ *  Created on: 2026.10.17
+ *  Author: gallenshao
+ */
+
+#include "allocator.h"
+#include "affinity.h"
+#include <cassert>
+#include <new>
+#include <sys/mman.h>
+
+namespace gs {
+
+void* HeapChunkAllocator::Allocate(size_t size) {
+  return ::operator new(size, std::align_val_t(CHUNK_ALIGNMENT));
+}
+
+void HeapChunkAllocator::Deallocate(void* ptr, size_t size) {
+  ::operator delete(ptr, std::align_val_t(CHUNK_ALIGNMENT));
+}
+
+ChunkPool::~ChunkPool() {
+  Trim();
+}
+
+void* ChunkPool::Allocate(size_t size) {
+  {
+    std::lock_guard<std::mutex> locker(lock_);
+    auto it = free_blocks_.find(size);
+    if (it != free_blocks_.end() && !it->second.empty()) {
+      auto ptr = it->second.back();
+      it->second.pop_back();
+      cached_bytes_ -= size;
+      return ptr;
+    }
+  }
+  return heap_.Allocate(size);
+}
+
+void ChunkPool::Deallocate(void* ptr, size_t size) {
+  {
+    std::lock_guard<std::mutex> locker(lock_);
+    if (cached_bytes_ + size <= max_cached_bytes_) {
+      free_blocks_[size].push_back(ptr);
+      cached_bytes_ += size;
+      return;
+    }
+  }
+  heap_.Deallocate(ptr, size);
+}
+
+void ChunkPool::Trim() {
+  std::lock_guard<std::mutex> locker(lock_);
+  for (auto& item : free_blocks_) {
+    for (auto ptr : item.second) {
+      heap_.Deallocate(ptr, item.first);
+    }
+  }
+  free_blocks_.clear();
+  cached_bytes_ = 0;
+}
+
+size_t ChunkPool::cached_bytes() const {
+  std::lock_guard<std::mutex> locker(lock_);
+  return cached_bytes_;
+}
+
+NodeLocalChunkAllocator::NodeLocalChunkAllocator() {
+  auto nodes = Affinity::Nodes();
+  nodes_.resize(nodes.back() + 1);
+  for (auto node : nodes) {
+    nodes_[node] = std::make_unique<Node>();
+  }
+  default_node_ = nodes.front();
+  node_count_ = nodes.size();
+}
+
+NodeLocalChunkAllocator::~NodeLocalChunkAllocator() {
+  for (auto& mapping : mappings_) {
+    munmap(const_cast<uint8_t*>(mapping.first), mapping.second.first);
+  }
+}
+
+void* NodeLocalChunkAllocator::Allocate(size_t size) {
+  auto index = Affinity::CurrentNode();
+  if (index < 0 || static_cast<size_t>(index) >= nodes_.size() || nodes_[index] == nullptr) {
+    index = default_node_;
+  }
+  auto& node = *nodes_[index];
+  std::lock_guard<std::mutex> locker(node.lock);
+  auto it = node.free_blocks.find(size);
+  if (it != node.free_blocks.end() && !it->second.empty()) {
+    auto ptr = it->second.back();
+    it->second.pop_back();
+    return ptr;
+  }
+
+  // large blocks get a mapping of their own, the rest of a slab too small for the block is left unused
+  size = (size + CHUNK_ALIGNMENT - 1) / CHUNK_ALIGNMENT * CHUNK_ALIGNMENT;
+  if (size > NODE_SLAB_SIZE / 4) {
+    return Map(size, index);
+  }
+  if (node.slab == nullptr || node.slab_used + size > NODE_SLAB_SIZE) {
+    node.slab = Map(NODE_SLAB_SIZE, index);
+    node.slab_used = 0;
+  }
+  auto ptr = node.slab + node.slab_used;
+  node.slab_used += size;
+  return ptr;
+}
+
+void NodeLocalChunkAllocator::Deallocate(void* ptr, size_t size) {
+  auto index = NodeOf(ptr);
+  assert(index >= 0);
+  auto& node = *nodes_[index];
+  std::lock_guard<std::mutex> locker(node.lock);
+  node.free_blocks[size].push_back(ptr);
+}
+
+int NodeLocalChunkAllocator::NodeOf(const void* ptr) const {
+  auto bytes = static_cast<const uint8_t*>(ptr);
+  std::lock_guard<std::mutex> locker(mappings_lock_);
+  auto it = mappings_.upper_bound(bytes);
+  if (it == mappings_.begin()) {
+    return -1;
+  }
+  --it;
+  return bytes < it->first + it->second.first ? it->second.second : -1;
+}
+
+uint8_t* NodeLocalChunkAllocator::Map(size_t size, int node) {
+  auto ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (ptr == MAP_FAILED) {
+    // like HeapChunkAllocator, the callers never check for nullptr
+    throw std::bad_alloc();
+  }
+  // bound before any page is touched, so that each one is placed on the node when first written
+  Affinity::BindMemory(ptr, size, node);
+  std::lock_guard<std::mutex> locker(mappings_lock_);
+  mappings_[static_cast<uint8_t*>(ptr)] = std::make_pair(size, node);
+  return static_cast<uint8_t*>(ptr);
+}
+
+}  // namespace gs
@@ -0,0 +1,144 @@
+/**
+ * Copyright 2026 by GallenShao, All Rights Reserved.
+ *
+ * archetype.cpp
+ *
+ *  Created on: 2026.10.17
+ *  Author: gallenshao
+ */
+
+#include "archetype.h"
+#include <algorithm>
+#include <cassert>
+#include <new>
+
+namespace gs {
+
+static size_t AlignUp(size_t value, size_t align) {
+  return (value + align - 1) / align * align;
+}
+
+Archetype::Archetype(const ComponentMask& mask, ChunkAllocator& allocator) : mask_(mask), allocator_(allocator) {
+  size_t row_bytes = sizeof(Entity);
+  size_t padding = 0;
+  for (ComponentBase::Family family = 0; family < MAX_COMPONENT_COUNT; family++) {
+    if (mask.test(family)) {
+      auto& info = ComponentBase::GetInfo(family);
+      families_.push_back(family);
+      infos_.push_back(info);
+      assert(info.align <= CHUNK_ALIGNMENT);
+      row_bytes += info.size;
+      padding += CHUNK_ALIGNMENT + sizeof(Tick);
+    }
+  }
+  padding += alignof(Tick);
+
+  if (!families_.empty()) {
+    column_index_.assign(families_.back() + 1, -1);
+  }
+  for (int i = 0; i < families_.size(); i++) {
+    column_index_[families_[i]] = i;
+  }
+
+  chunk_capacity_ = CHUNK_SIZE > padding ? static_cast<int>((CHUNK_SIZE - padding) / row_bytes) : 0;
+  if (chunk_capacity_ < 1) {
+    chunk_capacity_ = 1;
+  }
+  // full batches never straddle two chunks, and every column has room for whole batches. Chunks too small for a
+  // whole batch grow to hold one
+  if (chunk_capacity_ >= MAX_BATCH_SIZE) {
+    chunk_capacity_ = chunk_capacity_ / MAX_BATCH_SIZE * MAX_BATCH_SIZE;
+  } else {
+    chunk_capacity_ = MAX_BATCH_SIZE;
+  }
+
+  size_t offset = sizeof(Entity) * chunk_capacity_;
+  for (auto& info : infos_) {
+    offset = AlignUp(offset, CHUNK_ALIGNMENT);
+    column_offsets_.push_back(offset);
+    offset += info.size * chunk_capacity_;
+  }
+  ticks_offset_ = AlignUp(offset, alignof(Tick));
+  offset = ticks_offset_ + sizeof(Tick) * families_.size();
+  chunk_bytes_ = std::max(AlignUp(offset, CHUNK_ALIGNMENT), static_cast<size_t>(CHUNK_SIZE));
+}
+
+Archetype::~Archetype() {
+  for (auto& chunk : chunks_) {
+    for (int column = 0; column < infos_.size(); column++) {
+      auto& info = infos_[column];
+      auto data = chunk.data + column_offsets_[column];
+      for (int index = 0; index < chunk.size; index++) {
+        info.destroy(data + index * info.size);
+      }
+    }
+    allocator_.Deallocate(chunk.data, chunk_bytes_);
+  }
+  chunks_.clear();
+}
+
+Entity Archetype::EntityAt(size_t row) const {
+  assert(row < size_);
+  return Entities(chunks_[row / chunk_capacity_])[row % chunk_capacity_];
+}
+
+void* Archetype::At(size_t row, ComponentBase::Family family) const {
+  assert(row < size_);
+  if (!Has(family)) {
+    return nullptr;
+  }
+  auto column = column_index_[family];
+  auto& chunk = chunks_[row / chunk_capacity_];
+  return chunk.data + column_offsets_[column] + (row % chunk_capacity_) * infos_[column].size;
+}
+
+void Archetype::MarkChunkWritten(const Chunk& chunk, Tick tick) const {
+  auto ticks = Ticks(chunk);
+  for (int column = 0; column < families_.size(); column++) {
+    ticks[column] = tick;
+  }
+}
+
+size_t Archetype::Push(Entity entity, Tick tick) {
+  if (size_ == chunks_.size() * chunk_capacity_) {
+    Chunk chunk;
+    chunk.data = static_cast<uint8_t*>(allocator_.Allocate(chunk_bytes_));
+    chunks_.push_back(chunk);
+  }
+  auto& chunk = chunks_.back();
+  Entities(chunk)[chunk.size++] = entity;
+  MarkChunkWritten(chunk, tick);
+  return size_++;
+}
+
+Entity Archetype::EraseRelocated(size_t row, Tick tick) {
+  assert(row < size_);
+  auto last = size_ - 1;
+  Entity moved;
+  if (row != last) {
+    for (auto family : families_) {
+      infos_[column_index_[family]].relocate(At(row, family), At(last, family));
+    }
+    moved = EntityAt(last);
+    Entities(chunks_[row / chunk_capacity_])[row % chunk_capacity_] = moved;
+    MarkChunkWritten(chunks_[row / chunk_capacity_], tick);
+  }
+
+  auto& chunk = chunks_.back();
+  chunk.size--;
+  size_--;
+  if (chunk.size == 0) {
+    allocator_.Deallocate(chunk.data, chunk_bytes_);
+    chunks_.pop_back();
+  }
+  return moved;
+}
+
+Entity Archetype::Erase(size_t row, Tick tick) {
+  for (auto family : families_) {
+    infos_[column_index_[family]].destroy(At(row, family));
+  }
+  return EraseRelocated(row, tick);
+}
+
+}  // namespace gs
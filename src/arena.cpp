@@ -0,0 +1,56 @@
+/**
+ * Copyright 2026 by GallenShao, All Rights Reserved.
+ *
+ * arena.cpp
+ *
+ *  Created on: 2026.10.17
+ *  Author: gallenshao
+ */
+
+#include "arena.h"
+#include <algorithm>
+
+namespace gs {
+
+LinearArena::LinearArena(std::shared_ptr<ChunkAllocator> allocator, size_t block_size)
+    : allocator_(std::move(allocator)), block_size_(block_size) {
+  if (allocator_ == nullptr) {
+    allocator_ = std::make_shared<HeapChunkAllocator>();
+  }
+}
+
+LinearArena::~LinearArena() {
+  for (auto& block : blocks_) {
+    allocator_->Deallocate(block.data, block.size);
+  }
+}
+
+void* LinearArena::Allocate(size_t size, size_t align) {
+  for (; current_ < blocks_.size(); current_++, offset_ = 0) {
+    auto& block = blocks_[current_];
+    auto address = reinterpret_cast<uintptr_t>(block.data) + offset_;
+    auto padding = (align - address % align) % align;
+    if (offset_ + padding + size <= block.size) {
+      offset_ += padding + size;
+      used_ += size;
+      return reinterpret_cast<void*>(address + padding);
+    }
+  }
+
+  // oversized allocations get a block of their own
+  Block block;
+  block.size = std::max(block_size_, size + align);
+  block.data = static_cast<uint8_t*>(allocator_->Allocate(block.size));
+  blocks_.push_back(block);
+  current_ = blocks_.size() - 1;
+  offset_ = 0;
+  return Allocate(size, align);
+}
+
+void LinearArena::Reset() {
+  current_ = 0;
+  offset_ = 0;
+  used_ = 0;
+}
+
+}  // namespace gs
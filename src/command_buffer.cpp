@@ -0,0 +1,107 @@
+/**
+ * Copyright 2026 by GallenShao, All Rights Reserved.
+ *
+ * command_buffer.cpp
+ *
+ *  Created on: 2026.10.17
+ *  Author: gallenshao
+ */
+
+#include "command_buffer.h"
+#include "archetype.h"
+
+namespace gs {
+
+CommandBuffer::~CommandBuffer() {
+  Clear();
+}
+
+Entity CommandBuffer::Create() {
+  Entity entity(pending_count_++, PENDING_VERSION);
+  Append(CREATE, entity);
+  return entity;
+}
+
+void CommandBuffer::Destroy(Entity entity) {
+  Append(DESTROY, entity);
+}
+
+CommandBuffer::Command* CommandBuffer::Append(CommandType type, Entity entity, ComponentBase::Family family) {
+  auto command = arena_.New<Command>();
+  command->type = type;
+  command->entity = entity;
+  command->family = family;
+  if (tail_ != nullptr) {
+    tail_->next = command;
+  } else {
+    head_ = command;
+  }
+  tail_ = command;
+  return command;
+}
+
+Entity CommandBuffer::Resolve(Entity entity) const {
+  if (entity.version() == PENDING_VERSION && entity.index() < created_.size()) {
+    return created_[entity.index()];
+  }
+  return entity;
+}
+
+void CommandBuffer::Playback(EntityManager& manager) {
+  created_.resize(pending_count_);
+  for (auto command = head_; command != nullptr; command = command->next) {
+    if (command->type == CREATE) {
+      created_[command->entity.index()] = manager.Create();
+      continue;
+    }
+
+    auto entity = Resolve(command->entity);
+    auto valid = manager.Valid(entity);
+    switch (command->type) {
+      case DESTROY:
+        if (valid) {
+          manager.Destroy(entity);
+        }
+        break;
+      case ASSIGN: {
+        auto& info = ComponentBase::GetInfo(command->family);
+        if (valid) {
+          auto component = manager.WriteComponent(entity, command->family);
+          if (component != nullptr) {
+            info.destroy(component);
+          } else {
+            component = manager.AddComponent(entity, command->family);
+          }
+          info.relocate(component, command->component);
+        } else {
+          info.destroy(command->component);
+        }
+        command->component = nullptr;
+        break;
+      }
+      case REMOVE:
+        if (valid) {
+          manager.RemoveComponent(entity, command->family);
+        }
+        break;
+      default:
+        break;
+    }
+  }
+  Clear();
+}
+
+void CommandBuffer::Clear() {
+  for (auto command = head_; command != nullptr; command = command->next) {
+    if (command->component != nullptr) {
+      ComponentBase::GetInfo(command->family).destroy(command->component);
+    }
+  }
+  head_ = nullptr;
+  tail_ = nullptr;
+  pending_count_ = 0;
+  created_.clear();
+  arena_.Reset();
+}
+
+}  // namespace gs
@@ -0,0 +1,47 @@
+/**
+ * Copyright 2026 by GallenShao, All Rights Reserved.
+ *
+ * component.cpp
+ *
+ *  Created on: 2026.10.17
+ *  Author: gallenshao
+ */
+
+#include "component.h"
+#include <cassert>
+#include <cstring>
+
+namespace gs {
+
+ComponentBase::Family ComponentBase::family_count_ = 0;
+
+std::vector<ComponentBase::Info>& ComponentBase::infos() {
+  static std::vector<Info> infos;
+  return infos;
+}
+
+ComponentBase::Family ComponentBase::Register(const Info& info) {
+  auto family = family_count_++;
+  assert(family < MAX_COMPONENT_COUNT);
+  if (infos().size() <= family) {
+    infos().resize(family + 1);
+  }
+  infos()[family] = info;
+  return family;
+}
+
+ComponentBase::Family ComponentBase::FindFamily(const char* name) {
+  for (Family family = 0; family < infos().size(); family++) {
+    if (infos()[family].name != nullptr && std::strcmp(infos()[family].name, name) == 0) {
+      return family;
+    }
+  }
+  return -1;
+}
+
+const ComponentBase::Info& ComponentBase::GetInfo(Family family) {
+  assert(family < infos().size());
+  return infos()[family];
+}
+
+}  // namespace gs
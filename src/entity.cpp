@@ -0,0 +1,231 @@
+/**
+ * Copyright 2026 by GallenShao, All Rights Reserved.
+ *
+ * entity.cpp
+ *
+ *  Created on: 2026.10.17
+ *  Author: gallenshao
+ */
+
+#include "archetype.h"
+#include "sparse_set.h"
+#include <atomic>
+#include <cassert>
+
+namespace gs {
+
+namespace {
+
+std::atomic<uint64_t> manager_count = {0};
+
+}  // namespace
+
+thread_local Tick EntityManager::thread_tick_ = 0;
+
+EntityManager::EntityManager(std::shared_ptr<ChunkAllocator> allocator)
+    : id_(++manager_count), allocator_(std::move(allocator)) {
+  if (allocator_ == nullptr) {
+    allocator_ = std::make_shared<ChunkPool>();
+  }
+  GetArchetype(ComponentMask());
+}
+
+EntityManager::~EntityManager() = default;
+
+Entity EntityManager::Create() {
+  Entity::Index index;
+  if (free_list_.empty()) {
+    index = static_cast<Entity::Index>(locations_.size());
+    locations_.emplace_back();
+  } else {
+    index = free_list_.back();
+    free_list_.pop_back();
+  }
+
+  auto& location = locations_[index];
+  Entity entity(index, location.version);
+  location.archetype = GetArchetype(ComponentMask());
+  location.row = location.archetype->Push(entity, WriteTick());
+  size_++;
+  return entity;
+}
+
+void EntityManager::Destroy(Entity entity) {
+  assert(Valid(entity));
+  for (auto& set : sparse_sets_) {
+    if (set != nullptr) {
+      set->Remove(entity);
+    }
+  }
+  auto& location = locations_[entity.index()];
+  auto moved = location.archetype->Erase(location.row, WriteTick());
+  if (moved != Entity()) {
+    locations_[moved.index()].row = location.row;
+  }
+  // stale handles of this slot are rejected by the version check
+  location.archetype = nullptr;
+  location.version = location.version + 1 == Entity::RESERVED_VERSION ? 0 : location.version + 1;
+  free_list_.push_back(entity.index());
+  size_--;
+}
+
+Tick EntityManager::SetThreadTick(Tick tick) {
+  auto previous = thread_tick_;
+  thread_tick_ = tick;
+  return previous;
+}
+
+bool EntityManager::Valid(Entity entity) const {
+  return entity.index() < locations_.size() && locations_[entity.index()].version == entity.version() &&
+         locations_[entity.index()].archetype != nullptr;
+}
+
+Archetype* EntityManager::GetArchetype(const ComponentMask& mask) {
+  auto it = archetype_index_.find(mask);
+  if (it != archetype_index_.end()) {
+    return it->second;
+  }
+  archetypes_.push_back(std::make_unique<Archetype>(mask, *allocator_));
+  auto archetype = archetypes_.back().get();
+  archetype_index_[mask] = archetype;
+  return archetype;
+}
+
+void EntityManager::MoveEntity(Location& location, Archetype* target) {
+  auto source = location.archetype;
+  auto entity = source->EntityAt(location.row);
+  auto row = target->Push(entity, WriteTick());
+  for (auto family : source->families()) {
+    auto& info = ComponentBase::GetInfo(family);
+    auto component = source->At(location.row, family);
+    if (target->Has(family)) {
+      info.relocate(target->At(row, family), component);
+    } else {
+      info.destroy(component);
+    }
+  }
+  auto moved = source->EraseRelocated(location.row, WriteTick());
+  if (moved != Entity()) {
+    locations_[moved.index()].row = location.row;
+  }
+  location.archetype = target;
+  location.row = row;
+}
+
+void* EntityManager::AddComponent(Entity entity, ComponentBase::Family family) {
+  assert(Valid(entity));
+  if (ComponentBase::GetInfo(family).sparse) {
+    return GetSparseSet(family).Add(entity);
+  }
+  auto& location = locations_[entity.index()];
+  assert(!location.archetype->Has(family));
+  auto mask = location.archetype->mask();
+  mask.set(family);
+  MoveEntity(location, GetArchetype(mask));
+  return location.archetype->At(location.row, family);
+}
+
+void EntityManager::RemoveComponent(Entity entity, ComponentBase::Family family) {
+  assert(Valid(entity));
+  if (ComponentBase::GetInfo(family).sparse) {
+    GetSparseSet(family).Remove(entity);
+    return;
+  }
+  auto& location = locations_[entity.index()];
+  if (!location.archetype->Has(family)) {
+    return;
+  }
+  auto mask = location.archetype->mask();
+  mask.reset(family);
+  MoveEntity(location, GetArchetype(mask));
+}
+
+void* EntityManager::GetComponent(Entity entity, ComponentBase::Family family) const {
+  if (!Valid(entity)) {
+    return nullptr;
+  }
+  if (ComponentBase::GetInfo(family).sparse) {
+    return family < sparse_sets_.size() && sparse_sets_[family] != nullptr ? sparse_sets_[family]->Get(entity)
+                                                                             : nullptr;
+  }
+  auto& location = locations_[entity.index()];
+  return location.archetype->At(location.row, family);
+}
+
+void* EntityManager::WriteComponent(Entity entity, ComponentBase::Family family) {
+  auto component = GetComponent(entity, family);
+  if (component != nullptr && !ComponentBase::GetInfo(family).sparse) {
+    auto& location = locations_[entity.index()];
+    location.archetype->MarkWritten(location.row, family, WriteTick());
+  }
+  return component;
+}
+
+SparseSet& EntityManager::GetSparseSet(ComponentBase::Family family) {
+  assert(ComponentBase::GetInfo(family).sparse);
+  if (sparse_sets_.size() <= family) {
+    sparse_sets_.resize(family + 1);
+  }
+  auto& set = sparse_sets_[family];
+  if (set == nullptr) {
+    set = std::make_unique<SparseSet>(family, *allocator_);
+  }
+  return *set;
+}
+
+void EntityManager::Reset(std::shared_ptr<ChunkAllocator> allocator) {
+  // the archetypes and sets return their memory to the current allocator before it is replaced
+  sparse_sets_.clear();
+  archetype_index_.clear();
+  archetypes_.clear();
+  locations_.clear();
+  free_list_.clear();
+  size_ = 0;
+  tick_ = 1;
+  allocator_ = std::move(allocator);
+  GetArchetype(ComponentMask());
+}
+
+bool EntityManager::Relink(const Entity::Index* free_list, size_t free_count) {
+  for (auto& location : locations_) {
+    location.archetype = nullptr;
+    if (location.version == Entity::RESERVED_VERSION) {
+      return false;
+    }
+  }
+  size_ = 0;
+  for (auto& archetype : archetypes_) {
+    size_t row = 0;
+    for (auto& chunk : archetype->chunks()) {
+      for (int index = 0; index < chunk.size; index++, row++) {
+        auto entity = archetype->Entities(chunk)[index];
+        if (entity.index() >= locations_.size()) {
+          return false;
+        }
+        auto& location = locations_[entity.index()];
+        if (location.version != entity.version() || location.archetype != nullptr) {
+          return false;
+        }
+        location.archetype = archetype.get();
+        location.row = row;
+      }
+    }
+    size_ += archetype->size();
+  }
+
+  // restored verbatim, so that the next entities created get the same handles as in the captured world
+  if (size_ + free_count != locations_.size()) {
+    return false;
+  }
+  std::vector<bool> freed(locations_.size(), false);
+  free_list_.assign(free_list, free_list + free_count);
+  for (auto index : free_list_) {
+    if (index >= locations_.size() || locations_[index].archetype != nullptr || freed[index]) {
+      return false;
+    }
+    freed[index] = true;
+  }
+  return true;
+}
+
+}  // namespace gs
@@ -0,0 +1,653 @@
+/**
+ * Copyright 2026 by GallenShao, All Rights Reserved.
+ *
+ * frame_snapshot.cpp
+ *
+ *  Created on: 2026.10.17
+ *  Author: gallenshao
+ */
+
+#include "frame_snapshot.h"
+#include "archetype.h"
+#include "sparse_set.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <string>
+
+namespace gs {
+
+namespace {
+
+const char DELTA_MAGIC[8] = {'G', 'S', 'E', 'C', 'S', 'D', 'L', 'T'};
+// columns are compared by words, changed words closer than a run header are merged into one run
+const size_t DELTA_WORD = 8;
+const size_t DELTA_RUN_GAP = 2 * sizeof(uint32_t);
+
+enum BlockKind : uint8_t {
+  // same bytes as the base block
+  BLOCK_UNCHANGED = 0,
+  // length, then runs of (offset, length, bytes) patched over the base block
+  BLOCK_PATCHED = 1,
+};
+
+typedef std::shared_ptr<const std::vector<uint8_t>> Block;
+
+Block CopyBlock(const void* data, size_t size) {
+  auto begin = static_cast<const uint8_t*>(data);
+  return std::make_shared<const std::vector<uint8_t>>(begin, begin + size);
+}
+
+size_t BlockSize(const Block& block) {
+  return block != nullptr ? block->size() : 0;
+}
+
+// the delta is a byte stream without alignment, values are copied in and out
+class Writer {
+ public:
+  template <typename T>
+  void Put(const T& value) {
+    PutBytes(&value, sizeof(T));
+  }
+  void PutBytes(const void* data, size_t size) {
+    auto begin = static_cast<const uint8_t*>(data);
+    bytes_.insert(bytes_.end(), begin, begin + size);
+  }
+
+  // `target` as a patch over `base`, which may be nullptr
+  void PutBlock(const Block& base, const Block& target) {
+    auto base_size = BlockSize(base);
+    auto size = BlockSize(target);
+    std::vector<std::pair<size_t, size_t>> runs;
+    if (base != target) {
+      for (size_t offset = 0; offset < size; offset += DELTA_WORD) {
+        auto length = std::min(DELTA_WORD, size - offset);
+        if (offset + length <= base_size && std::memcmp(base->data() + offset, target->data() + offset, length) == 0) {
+          continue;
+        }
+        if (!runs.empty() && offset - (runs.back().first + runs.back().second) <= DELTA_RUN_GAP) {
+          runs.back().second = offset + length - runs.back().first;
+        } else {
+          runs.emplace_back(offset, length);
+        }
+      }
+    }
+    if (runs.empty() && base_size == size) {
+      Put(BLOCK_UNCHANGED);
+      return;
+    }
+    Put(BLOCK_PATCHED);
+    Put(static_cast<uint32_t>(size));
+    Put(static_cast<uint32_t>(runs.size()));
+    for (auto& run : runs) {
+      Put(static_cast<uint32_t>(run.first));
+      Put(static_cast<uint32_t>(run.second));
+      PutBytes(target->data() + run.first, run.second);
+    }
+  }
+
+  std::vector<uint8_t>& bytes() { return bytes_; }
+
+ private:
+  std::vector<uint8_t> bytes_;
+};
+
+// bounds-checked, every read fails once one of them is out of range
+class Reader {
+ public:
+  explicit Reader(const std::vector<uint8_t>& bytes) : bytes_(bytes) {}
+
+  template <typename T>
+  bool Get(T& value) {
+    auto data = Take(sizeof(T));
+    if (data != nullptr) {
+      std::memcpy(&value, data, sizeof(T));
+    }
+    return data != nullptr;
+  }
+
+  const uint8_t* Take(size_t size) {
+    if (failed_ || size > bytes_.size() - offset_) {
+      failed_ = true;
+      return nullptr;
+    }
+    auto result = bytes_.data() + offset_;
+    offset_ += size;
+    return result;
+  }
+
+  size_t remaining() const { return bytes_.size() - offset_; }
+
+  // the block written by Writer::PutBlock against `base`
+  bool GetBlock(const Block& base, Block& block) {
+    uint8_t kind = 0;
+    if (!Get(kind)) {
+      return false;
+    }
+    if (kind == BLOCK_UNCHANGED) {
+      block = base;
+      return true;
+    }
+    uint32_t size = 0;
+    uint32_t run_count = 0;
+    if (kind != BLOCK_PATCHED || !Get(size) || !Get(run_count)) {
+      return false;
+    }
+    // bytes past the base block are always patched, so a larger size comes from a malformed delta
+    if (size > BlockSize(base) + remaining()) {
+      failed_ = true;
+      return false;
+    }
+    auto bytes = base != nullptr ? *base : std::vector<uint8_t>();
+    bytes.resize(size);
+    for (uint32_t run = 0; run < run_count; run++) {
+      uint32_t offset = 0;
+      uint32_t length = 0;
+      if (!Get(offset) || !Get(length) || offset > size || length > size - offset) {
+        return false;
+      }
+      auto data = Take(length);
+      if (data == nullptr) {
+        return false;
+      }
+      std::memcpy(bytes.data() + offset, data, length);
+    }
+    block = std::make_shared<const std::vector<uint8_t>>(std::move(bytes));
+    return true;
+  }
+
+ private:
+  const std::vector<uint8_t>& bytes_;
+  size_t offset_ = 0;
+  bool failed_ = false;
+};
+
+}  // namespace
+
+std::shared_ptr<const FrameSnapshot> FrameSnapshot::Capture(const EntityManager& manager,
+                                                            const FrameSnapshot* previous) {
+  if (previous != nullptr && previous->source_ != manager.id_) {
+    previous = nullptr;
+  }
+  // writes stamped with the tick of the previous capture may have happened after it, they are copied again
+  auto unchanged = [previous](Tick tick) { return previous != nullptr && tick < previous->tick_; };
+
+  auto snapshot = std::make_shared<FrameSnapshot>();
+  snapshot->source_ = manager.id_;
+  snapshot->tick_ = manager.tick_;
+  snapshot->size_ = manager.size_;
+
+  std::vector<Entity::Version> versions;
+  versions.reserve(manager.locations_.size());
+  for (auto& location : manager.locations_) {
+    versions.push_back(location.version);
+  }
+  auto versions_size = sizeof(Entity::Version) * versions.size();
+  if (previous != nullptr && BlockSize(previous->versions_) == versions_size &&
+      std::memcmp(previous->versions_->data(), versions.data(), versions_size) == 0) {
+    snapshot->versions_ = previous->versions_;
+  } else {
+    snapshot->versions_ = CopyBlock(versions.data(), versions_size);
+  }
+  auto free_size = sizeof(Entity::Index) * manager.free_list_.size();
+  if (previous != nullptr && BlockSize(previous->free_list_) == free_size &&
+      std::memcmp(previous->free_list_->data(), manager.free_list_.data(), free_size) == 0) {
+    snapshot->free_list_ = previous->free_list_;
+  } else {
+    snapshot->free_list_ = CopyBlock(manager.free_list_.data(), free_size);
+  }
+
+  for (auto& archetype : manager.archetypes_) {
+    if (archetype->size() == 0) {
+      continue;
+    }
+    for (auto family : archetype->families()) {
+      if (!ComponentBase::GetInfo(family).trivially_copyable) {
+        return nullptr;
+      }
+    }
+    ArchetypeState state;
+    state.mask = archetype->mask();
+    state.families = archetype->families();
+    auto old = previous != nullptr ? previous->FindArchetype(state.mask) : nullptr;
+
+    for (size_t index = 0; index < archetype->chunks().size(); index++) {
+      auto& chunk = archetype->chunks()[index];
+      auto old_chunk = old != nullptr && index < old->chunks.size() && old->chunks[index].size == chunk.size
+                           ? &old->chunks[index]
+                           : nullptr;
+      ChunkState chunk_state;
+      chunk_state.size = chunk.size;
+      // entities are only moved by structural changes, which mark every column of the chunk
+      bool same_entities = old_chunk != nullptr && !state.families.empty();
+      for (size_t column = 0; column < state.families.size(); column++) {
+        auto family = state.families[column];
+        if (old_chunk != nullptr && unchanged(archetype->ColumnTick(chunk, family))) {
+          chunk_state.columns.push_back(old_chunk->columns[column]);
+        } else {
+          auto& info = ComponentBase::GetInfo(family);
+          chunk_state.columns.push_back(CopyBlock(archetype->Column(chunk, family), info.size * chunk.size));
+          same_entities = false;
+        }
+      }
+      chunk_state.entities =
+          same_entities ? old_chunk->entities : CopyBlock(archetype->Entities(chunk), sizeof(Entity) * chunk.size);
+      state.chunks.push_back(std::move(chunk_state));
+    }
+    snapshot->archetypes_.push_back(std::move(state));
+  }
+
+  // sparse sets have no change ticks, they are compared with the previous capture instead
+  for (auto& set : manager.sparse_sets_) {
+    if (set == nullptr || set->size() == 0) {
+      continue;
+    }
+    auto& info = ComponentBase::GetInfo(set->family());
+    if (!info.trivially_copyable) {
+      return nullptr;
+    }
+    SparseState state;
+    state.family = set->family();
+    auto old = previous != nullptr ? previous->FindSparse(set->family()) : nullptr;
+
+    auto entities_size = sizeof(Entity) * set->size();
+    if (old != nullptr && old->entities->size() == entities_size &&
+        std::memcmp(old->entities->data(), set->entities().data(), entities_size) == 0) {
+      state.entities = old->entities;
+    } else {
+      state.entities = CopyBlock(set->entities().data(), entities_size);
+    }
+
+    bool same_components = old != nullptr && old->components->size() == info.size * set->size();
+    for (size_t index = 0; same_components && index < set->size(); index++) {
+      same_components = std::memcmp(old->components->data() + info.size * index, set->At(index), info.size) == 0;
+    }
+    if (same_components) {
+      state.components = old->components;
+    } else {
+      std::vector<uint8_t> components(info.size * set->size());
+      for (size_t index = 0; index < set->size(); index++) {
+        std::memcpy(components.data() + info.size * index, set->At(index), info.size);
+      }
+      state.components = std::make_shared<const std::vector<uint8_t>>(std::move(components));
+    }
+    snapshot->sparse_sets_.push_back(std::move(state));
+  }
+  return snapshot;
+}
+
+std::vector<uint8_t> FrameSnapshot::Diff(const FrameSnapshot& base, const FrameSnapshot& target) {
+  // components of the target, indexed in the delta by order of appearance
+  std::vector<int> component_index(MAX_COMPONENT_COUNT, -1);
+  std::vector<ComponentBase::Family> components;
+  auto use = [&component_index, &components](ComponentBase::Family family) {
+    if (component_index[family] < 0) {
+      component_index[family] = static_cast<int>(components.size());
+      components.push_back(family);
+    }
+  };
+  for (auto& state : target.archetypes_) {
+    for (auto family : state.families) {
+      use(family);
+    }
+  }
+  for (auto& state : target.sparse_sets_) {
+    use(state.family);
+  }
+
+  Writer writer;
+  writer.PutBytes(DELTA_MAGIC, sizeof(DELTA_MAGIC));
+  writer.Put(static_cast<uint32_t>(FRAME_DELTA_VERSION));
+  writer.Put(base.tick_);
+  writer.Put(static_cast<uint64_t>(base.size_));
+  writer.Put(target.tick_);
+  writer.Put(static_cast<uint64_t>(target.size_));
+
+  writer.Put(static_cast<uint32_t>(components.size()));
+  for (auto family : components) {
+    auto& info = ComponentBase::GetInfo(family);
+    auto name_length = std::strlen(info.name);
+    writer.Put(static_cast<uint32_t>(info.size));
+    writer.Put(static_cast<uint32_t>(name_length));
+    writer.PutBytes(info.name, name_length);
+  }
+
+  writer.PutBlock(base.versions_, target.versions_);
+  writer.PutBlock(base.free_list_, target.free_list_);
+
+  writer.Put(static_cast<uint32_t>(target.archetypes_.size()));
+  for (auto& state : target.archetypes_) {
+    writer.Put(static_cast<uint32_t>(state.families.size()));
+    for (auto family : state.families) {
+      writer.Put(static_cast<uint32_t>(component_index[family]));
+    }
+    // archetypes of the same mask have the same columns
+    auto old = base.FindArchetype(state.mask);
+    writer.Put(static_cast<uint32_t>(state.chunks.size()));
+    for (size_t index = 0; index < state.chunks.size(); index++) {
+      auto& chunk = state.chunks[index];
+      auto old_chunk = old != nullptr && index < old->chunks.size() ? &old->chunks[index] : nullptr;
+      writer.Put(static_cast<uint32_t>(chunk.size));
+      writer.PutBlock(old_chunk != nullptr ? old_chunk->entities : nullptr, chunk.entities);
+      for (size_t column = 0; column < chunk.columns.size(); column++) {
+        writer.PutBlock(old_chunk != nullptr ? old_chunk->columns[column] : nullptr, chunk.columns[column]);
+      }
+    }
+  }
+
+  writer.Put(static_cast<uint32_t>(target.sparse_sets_.size()));
+  for (auto& state : target.sparse_sets_) {
+    auto old = base.FindSparse(state.family);
+    writer.Put(static_cast<uint32_t>(component_index[state.family]));
+    writer.PutBlock(old != nullptr ? old->entities : nullptr, state.entities);
+    writer.PutBlock(old != nullptr ? old->components : nullptr, state.components);
+  }
+  return std::move(writer.bytes());
+}
+
+std::shared_ptr<const FrameSnapshot> FrameSnapshot::Apply(const FrameSnapshot& base,
+                                                          const std::vector<uint8_t>& delta) {
+  Reader reader(delta);
+  auto magic = reader.Take(sizeof(DELTA_MAGIC));
+  uint32_t version = 0;
+  Tick base_tick = 0;
+  uint64_t base_size = 0;
+  auto snapshot = std::make_shared<FrameSnapshot>();
+  uint64_t size = 0;
+  uint32_t component_count = 0;
+  if (magic == nullptr || std::memcmp(magic, DELTA_MAGIC, sizeof(DELTA_MAGIC)) != 0 || !reader.Get(version) ||
+      version != FRAME_DELTA_VERSION || !reader.Get(base_tick) || !reader.Get(base_size) ||
+      !reader.Get(snapshot->tick_) || !reader.Get(size) || !reader.Get(component_count)) {
+    return nullptr;
+  }
+  if (base_tick != base.tick_ || base_size != base.size_) {
+    return nullptr;
+  }
+  snapshot->size_ = size;
+
+  std::vector<ComponentBase::Family> families;
+  for (uint32_t index = 0; index < component_count; index++) {
+    uint32_t component_size = 0;
+    uint32_t name_length = 0;
+    if (!reader.Get(component_size) || !reader.Get(name_length)) {
+      return nullptr;
+    }
+    auto name = reader.Take(name_length);
+    if (name == nullptr) {
+      return nullptr;
+    }
+    auto family = ComponentBase::FindFamily(std::string(reinterpret_cast<const char*>(name), name_length).c_str());
+    if (family < 0 || ComponentBase::GetInfo(family).size != component_size ||
+        !ComponentBase::GetInfo(family).trivially_copyable) {
+      return nullptr;
+    }
+    families.push_back(family);
+  }
+
+  if (!reader.GetBlock(base.versions_, snapshot->versions_) ||
+      !reader.GetBlock(base.free_list_, snapshot->free_list_)) {
+    return nullptr;
+  }
+
+  uint32_t archetype_count = 0;
+  if (!reader.Get(archetype_count)) {
+    return nullptr;
+  }
+  for (uint32_t index = 0; index < archetype_count; index++) {
+    uint32_t column_count = 0;
+    if (!reader.Get(column_count) || column_count > families.size()) {
+      return nullptr;
+    }
+    // columns are sent in the order of the sender families, they are kept in the order of the local ones
+    std::vector<ComponentBase::Family> columns(column_count);
+    ArchetypeState state;
+    for (auto& family : columns) {
+      uint32_t component = 0;
+      if (!reader.Get(component) || component >= families.size() ||
+          ComponentBase::GetInfo(families[component]).sparse || state.mask.test(families[component])) {
+        return nullptr;
+      }
+      family = families[component];
+      state.mask.set(family);
+    }
+    state.families = columns;
+    std::sort(state.families.begin(), state.families.end());
+    std::vector<size_t> positions;
+    for (auto family : columns) {
+      positions.push_back(std::lower_bound(state.families.begin(), state.families.end(), family) -
+                          state.families.begin());
+    }
+
+    auto old = base.FindArchetype(state.mask);
+    uint32_t chunk_count = 0;
+    if (!reader.Get(chunk_count)) {
+      return nullptr;
+    }
+    for (uint32_t chunk_index = 0; chunk_index < chunk_count; chunk_index++) {
+      auto old_chunk = old != nullptr && chunk_index < old->chunks.size() ? &old->chunks[chunk_index] : nullptr;
+      ChunkState chunk;
+      uint32_t chunk_size = 0;
+      if (!reader.Get(chunk_size) ||
+          !reader.GetBlock(old_chunk != nullptr ? old_chunk->entities : nullptr, chunk.entities)) {
+        return nullptr;
+      }
+      chunk.size = static_cast<int>(chunk_size);
+      chunk.columns.resize(column_count);
+      for (auto position : positions) {
+        if (!reader.GetBlock(old_chunk != nullptr ? old_chunk->columns[position] : nullptr, chunk.columns[position])) {
+          return nullptr;
+        }
+      }
+      state.chunks.push_back(std::move(chunk));
+    }
+    snapshot->archetypes_.push_back(std::move(state));
+  }
+
+  uint32_t sparse_count = 0;
+  if (!reader.Get(sparse_count)) {
+    return nullptr;
+  }
+  for (uint32_t index = 0; index < sparse_count; index++) {
+    uint32_t component = 0;
+    if (!reader.Get(component) || component >= families.size() || !ComponentBase::GetInfo(families[component]).sparse) {
+      return nullptr;
+    }
+    SparseState state;
+    state.family = families[component];
+    auto old = base.FindSparse(state.family);
+    if (!reader.GetBlock(old != nullptr ? old->entities : nullptr, state.entities) ||
+        !reader.GetBlock(old != nullptr ? old->components : nullptr, state.components)) {
+      return nullptr;
+    }
+    snapshot->sparse_sets_.push_back(std::move(state));
+  }
+  return snapshot->Validate() ? snapshot : nullptr;
+}
+
+void FrameSnapshot::Restore(EntityManager& manager) const {
+  auto tick = manager.tick_;
+  manager.Reset(manager.allocator_);
+  manager.tick_ = tick;
+  auto write_tick = manager.WriteTick();
+
+  auto versions = reinterpret_cast<const Entity::Version*>(versions_ != nullptr ? versions_->data() : nullptr);
+  manager.locations_.resize(BlockSize(versions_) / sizeof(Entity::Version));
+  for (size_t index = 0; index < manager.locations_.size(); index++) {
+    manager.locations_[index].version = versions[index];
+  }
+
+  // rows are packed again into chunks of the local capacity
+  for (auto& state : archetypes_) {
+    auto archetype = manager.GetArchetype(state.mask);
+    auto capacity = archetype->chunk_capacity();
+    for (auto& chunk_state : state.chunks) {
+      for (int row = 0; row < chunk_state.size;) {
+        if (archetype->size_ == archetype->chunks_.size() * capacity) {
+          Chunk chunk;
+          chunk.data = static_cast<uint8_t*>(manager.allocator_->Allocate(archetype->chunk_bytes_));
+          archetype->chunks_.push_back(chunk);
+        }
+        auto& chunk = archetype->chunks_.back();
+        auto count = std::min(chunk_state.size - row, capacity - chunk.size);
+        std::memcpy(archetype->Entities(chunk) + chunk.size, chunk_state.entities->data() + sizeof(Entity) * row,
+                    sizeof(Entity) * count);
+        for (size_t column = 0; column < state.families.size(); column++) {
+          auto family = state.families[column];
+          auto component_size = ComponentBase::GetInfo(family).size;
+          std::memcpy(static_cast<uint8_t*>(archetype->Column(chunk, family)) + component_size * chunk.size,
+                      chunk_state.columns[column]->data() + component_size * row, component_size * count);
+        }
+        archetype->MarkChunkWritten(chunk, write_tick);
+        chunk.size += count;
+        archetype->size_ += count;
+        row += count;
+      }
+    }
+  }
+  auto free_list = reinterpret_cast<const Entity::Index*>(free_list_ != nullptr ? free_list_->data() : nullptr);
+  auto linked = manager.Relink(free_list, BlockSize(free_list_) / sizeof(Entity::Index));
+  assert(linked);
+
+  for (auto& state : sparse_sets_) {
+    auto& set = manager.GetSparseSet(state.family);
+    auto component_size = ComponentBase::GetInfo(state.family).size;
+    auto entities = reinterpret_cast<const Entity*>(state.entities->data());
+    for (size_t index = 0; index < state.entities->size() / sizeof(Entity); index++) {
+      std::memcpy(set.Add(entities[index]), state.components->data() + component_size * index, component_size);
+    }
+  }
+}
+
+size_t FrameSnapshot::bytes() const {
+  auto bytes = BlockSize(versions_) + BlockSize(free_list_);
+  for (auto& state : archetypes_) {
+    for (auto& chunk : state.chunks) {
+      bytes += BlockSize(chunk.entities);
+      for (auto& column : chunk.columns) {
+        bytes += BlockSize(column);
+      }
+    }
+  }
+  for (auto& state : sparse_sets_) {
+    bytes += BlockSize(state.entities) + BlockSize(state.components);
+  }
+  return bytes;
+}
+
+const FrameSnapshot::ArchetypeState* FrameSnapshot::FindArchetype(const ComponentMask& mask) const {
+  for (auto& state : archetypes_) {
+    if (state.mask == mask) {
+      return &state;
+    }
+  }
+  return nullptr;
+}
+
+const FrameSnapshot::SparseState* FrameSnapshot::FindSparse(ComponentBase::Family family) const {
+  for (auto& state : sparse_sets_) {
+    if (state.family == family) {
+      return &state;
+    }
+  }
+  return nullptr;
+}
+
+bool FrameSnapshot::Validate() const {
+  auto slot_count = BlockSize(versions_) / sizeof(Entity::Version);
+  if (BlockSize(versions_) % sizeof(Entity::Version) != 0) {
+    return false;
+  }
+  std::vector<Entity::Version> versions(slot_count);
+  if (slot_count > 0) {
+    std::memcpy(versions.data(), versions_->data(), versions_->size());
+  }
+  if (std::find(versions.begin(), versions.end(), Entity::RESERVED_VERSION) != versions.end()) {
+    return false;
+  }
+  std::vector<bool> alive(slot_count, false);
+  auto valid = [&versions](const Entity& entity) {
+    return entity.index() < versions.size() && versions[entity.index()] == entity.version();
+  };
+
+  size_t size = 0;
+  for (auto& state : archetypes_) {
+    for (auto& chunk : state.chunks) {
+      if (chunk.size <= 0 || BlockSize(chunk.entities) != sizeof(Entity) * chunk.size) {
+        return false;
+      }
+      for (size_t column = 0; column < state.families.size(); column++) {
+        if (BlockSize(chunk.columns[column]) != ComponentBase::GetInfo(state.families[column]).size * chunk.size) {
+          return false;
+        }
+      }
+      for (int row = 0; row < chunk.size; row++) {
+        Entity entity;
+        std::memcpy(&entity, chunk.entities->data() + sizeof(Entity) * row, sizeof(Entity));
+        if (!valid(entity) || alive[entity.index()]) {
+          return false;
+        }
+        alive[entity.index()] = true;
+      }
+      size += chunk.size;
+    }
+  }
+
+  for (auto& state : sparse_sets_) {
+    auto count = BlockSize(state.entities) / sizeof(Entity);
+    if (BlockSize(state.entities) % sizeof(Entity) != 0 ||
+        BlockSize(state.components) != ComponentBase::GetInfo(state.family).size * count) {
+      return false;
+    }
+    std::vector<bool> seen(slot_count, false);
+    for (size_t index = 0; index < count; index++) {
+      Entity entity;
+      std::memcpy(&entity, state.entities->data() + sizeof(Entity) * index, sizeof(Entity));
+      if (!valid(entity) || !alive[entity.index()] || seen[entity.index()]) {
+        return false;
+      }
+      seen[entity.index()] = true;
+    }
+  }
+  // every other slot is free exactly once
+  auto free_count = BlockSize(free_list_) / sizeof(Entity::Index);
+  if (BlockSize(free_list_) % sizeof(Entity::Index) != 0 || size + free_count != slot_count) {
+    return false;
+  }
+  for (size_t index = 0; index < free_count; index++) {
+    Entity::Index slot;
+    std::memcpy(&slot, free_list_->data() + sizeof(Entity::Index) * index, sizeof(Entity::Index));
+    if (slot >= slot_count || alive[slot]) {
+      return false;
+    }
+    alive[slot] = true;
+  }
+  return size == size_;
+}
+
+std::shared_ptr<const FrameSnapshot> SnapshotHistory::Capture(const EntityManager& manager) {
+  auto snapshot = FrameSnapshot::Capture(manager, snapshots_.empty() ? nullptr : snapshots_.back().get());
+  if (snapshot == nullptr) {
+    return nullptr;
+  }
+  snapshots_.push_back(snapshot);
+  while (snapshots_.size() > capacity_) {
+    snapshots_.pop_front();
+  }
+  return snapshot;
+}
+
+std::shared_ptr<const FrameSnapshot> SnapshotHistory::Get(size_t frames) const {
+  return frames < snapshots_.size() ? snapshots_[snapshots_.size() - 1 - frames] : nullptr;
+}
+
+bool SnapshotHistory::Rollback(EntityManager& manager, size_t frames) {
+  auto snapshot = Get(frames);
+  if (snapshot == nullptr) {
+    return false;
+  }
+  snapshot->Restore(manager);
+  snapshots_.resize(snapshots_.size() - frames);
+  return true;
+}
+
+}  // namespace gs
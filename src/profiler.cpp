@@ -0,0 +1,210 @@
+/**
+ * Copyright 2026 by GallenShao, All Rights Reserved.
+ *
+ * profiler.cpp
+ *
+ *  Created on: 2026.10.17
+ *  Author: gallenshao
+ */
+
+#include "profiler.h"
+#include "thread_cache.h"
+#include <algorithm>
+
+namespace gs {
+
+namespace {
+
+double Percentile(std::vector<int64_t> values, double percent) {
+  if (values.empty()) {
+    return 0;
+  }
+  auto rank = static_cast<size_t>(percent * (values.size() - 1) + 0.5);
+  std::nth_element(values.begin(), values.begin() + rank, values.end());
+  return values[rank] / 1000.0;
+}
+
+void WriteString(std::ostream& stream, const std::string& value) {
+  stream << '"';
+  for (auto c : value) {
+    if (c == '"' || c == '\\') {
+      stream << '\\' << c;
+    } else if (static_cast<unsigned char>(c) >= 0x20) {
+      stream << c;
+    }
+  }
+  stream << '"';
+}
+
+// nanoseconds as fixed-point microseconds, the default stream precision loses the sub-microsecond digits and
+// even whole microseconds once the profiler has run for a while
+void WriteMicroseconds(std::ostream& stream, int64_t nanoseconds) {
+  if (nanoseconds < 0) {
+    stream << '-';
+    nanoseconds = -nanoseconds;
+  }
+  auto fraction = nanoseconds % 1000;
+  stream << nanoseconds / 1000 << '.' << fraction / 100 << fraction / 10 % 10 << fraction % 10;
+}
+
+}  // namespace
+
+FrameProfiler::RingBuffer::RingBuffer(int thread)
+    : thread(thread), events_(new Event[PROFILER_BUFFER_SIZE]) {}
+
+bool FrameProfiler::RingBuffer::Push(const Event& event) {
+  auto head = head_.load(std::memory_order_relaxed);
+  if (head - tail_.load(std::memory_order_acquire) >= PROFILER_BUFFER_SIZE) {
+    dropped.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  events_[head % PROFILER_BUFFER_SIZE] = event;
+  head_.store(head + 1, std::memory_order_release);
+  return true;
+}
+
+template <typename F>
+void FrameProfiler::RingBuffer::PopAll(F&& func) {
+  auto tail = tail_.load(std::memory_order_relaxed);
+  auto head = head_.load(std::memory_order_acquire);
+  for (; tail != head; tail++) {
+    func(events_[tail % PROFILER_BUFFER_SIZE]);
+  }
+  tail_.store(tail, std::memory_order_release);
+}
+
+FrameProfiler::FrameProfiler(int window, size_t max_trace_events)
+    : id_(ThreadLocalCache<RingBuffer>::NewOwner()),
+      window_(std::max(window, 1)),
+      max_trace_events_(max_trace_events) {}
+
+FrameProfiler::~FrameProfiler() = default;
+
+int64_t FrameProfiler::Now() const {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch_).count();
+}
+
+void FrameProfiler::BeginFrame() {
+  frame_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void FrameProfiler::Record(Family family, int64_t ready, int64_t start, int64_t end) {
+  auto& buffer = GetThreadBuffer();
+  buffer.Push({family, buffer.thread, frame_.load(std::memory_order_relaxed), ready, start, end});
+}
+
+FrameProfiler::RingBuffer& FrameProfiler::GetThreadBuffer() {
+  auto cached = ThreadLocalCache<RingBuffer>::Get(id_);
+  if (cached != nullptr) {
+    return *cached;
+  }
+
+  std::lock_guard<std::mutex> locker(buffers_lock_);
+  RingBuffer* buffer = nullptr;
+  for (auto& item : buffers_) {
+    if (item->owner == std::this_thread::get_id()) {
+      buffer = item.get();
+    }
+  }
+  if (buffer == nullptr) {
+    buffers_.push_back(std::make_unique<RingBuffer>(static_cast<int>(buffers_.size())));
+    buffer = buffers_.back().get();
+  }
+  ThreadLocalCache<RingBuffer>::Set(id_, buffer);
+  return *buffer;
+}
+
+void FrameProfiler::Collect() {
+  std::lock_guard<std::mutex> locker(buffers_lock_);
+  for (auto& buffer : buffers_) {
+    buffer->PopAll([this](const Event& event) {
+      if (events_.size() < max_trace_events_) {
+        events_.push_back(event);
+      }
+
+      if (samples_.size() <= event.family) {
+        samples_.resize(event.family + 1);
+      }
+      auto& samples = samples_[event.family];
+      auto duration = event.end - event.start;
+      auto wait = event.start - event.ready;
+      if (samples.durations.size() < static_cast<size_t>(window_)) {
+        samples.durations.push_back(duration);
+        samples.waits.push_back(wait);
+      } else {
+        samples.durations[samples.next] = duration;
+        samples.waits[samples.next] = wait;
+      }
+      samples.next = (samples.next + 1) % window_;
+    });
+  }
+}
+
+void FrameProfiler::SetName(Family family, const std::string& name) {
+  if (names_.size() <= family) {
+    names_.resize(family + 1);
+  }
+  names_[family] = name;
+}
+
+FrameProfiler::Stats FrameProfiler::GetStats(Family family) const {
+  Stats stats;
+  if (family < samples_.size()) {
+    auto& samples = samples_[family];
+    stats.samples = static_cast<int>(samples.durations.size());
+    stats.p50 = Percentile(samples.durations, 0.5);
+    stats.p99 = Percentile(samples.durations, 0.99);
+    stats.wait_p50 = Percentile(samples.waits, 0.5);
+    stats.wait_p99 = Percentile(samples.waits, 0.99);
+  }
+  return stats;
+}
+
+uint64_t FrameProfiler::dropped_count() const {
+  std::lock_guard<std::mutex> locker(buffers_lock_);
+  uint64_t count = 0;
+  for (auto& buffer : buffers_) {
+    count += buffer->dropped.load(std::memory_order_relaxed);
+  }
+  return count;
+}
+
+void FrameProfiler::WriteChromeTrace(std::ostream& stream) const {
+  stream << "{\"traceEvents\":[";
+  bool first = true;
+  int thread_count = 0;
+  for (auto& event : events_) {
+    thread_count = std::max(thread_count, event.thread + 1);
+  }
+  for (int thread = 0; thread < thread_count; thread++) {
+    stream << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << thread
+           << ",\"args\":{\"name\":\"worker " << thread << "\"}}";
+    first = false;
+  }
+
+  for (auto& event : events_) {
+    stream << (first ? "" : ",") << "\n{\"name\":";
+    if (event.family < names_.size() && !names_[event.family].empty()) {
+      WriteString(stream, names_[event.family]);
+    } else {
+      stream << "\"system " << event.family << '"';
+    }
+    // trace-event timestamps are microseconds
+    stream << ",\"cat\":\"system\",\"ph\":\"X\",\"pid\":0,\"tid\":" << event.thread << ",\"ts\":";
+    WriteMicroseconds(stream, event.start);
+    stream << ",\"dur\":";
+    WriteMicroseconds(stream, event.end - event.start);
+    stream << ",\"args\":{\"frame\":" << event.frame << ",\"wait_us\":";
+    WriteMicroseconds(stream, event.start - event.ready);
+    stream << "}}";
+    first = false;
+  }
+  stream << "\n]}\n";
+}
+
+void FrameProfiler::Clear() {
+  events_.clear();
+  samples_.clear();
+}
+
+}  // namespace gs
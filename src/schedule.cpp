@@ -0,0 +1,97 @@
+/**
+ * Copyright 2026 by GallenShao, All Rights Reserved.
+ *
+ * schedule.cpp
+ *
+ *  Created on: 2026.10.17
+ *  Author: gallenshao
+ */
+
+#include "schedule.h"
+#include "system.h"
+#include <algorithm>
+
+namespace gs {
+
+void FrameSchedule::Build(const std::vector<std::shared_ptr<BaseSystem>>& systems) {
+  auto family_count = static_cast<int>(systems.size());
+
+  // longest path from the roots, by Kahn's algorithm
+  std::vector<int> remaining(family_count, 0);
+  std::vector<int> family_levels(family_count, 0);
+  std::vector<Family> ready;
+  int system_count = 0;
+  for (Family family = 0; family < family_count; family++) {
+    if (systems[family] != nullptr) {
+      remaining[family] = static_cast<int>(systems[family]->dependencies_.size());
+      if (remaining[family] == 0) {
+        ready.push_back(family);
+      }
+      system_count++;
+    }
+  }
+
+  std::vector<Family> order;
+  order.reserve(system_count);
+  while (!ready.empty()) {
+    auto family = ready.back();
+    ready.pop_back();
+    order.push_back(family);
+    for (auto& next_family : systems[family]->next_) {
+      family_levels[next_family] = std::max(family_levels[next_family], family_levels[family] + 1);
+      if (--remaining[next_family] == 0) {
+        ready.push_back(next_family);
+      }
+    }
+  }
+  assert(order.size() == system_count);
+
+  std::stable_sort(order.begin(), order.end(), [&family_levels](Family a, Family b) {
+    return family_levels[a] != family_levels[b] ? family_levels[a] < family_levels[b] : a < b;
+  });
+
+  families_ = order;
+  family_to_index_.assign(family_count, -1);
+  levels_.resize(system_count);
+  level_offsets_.clear();
+  for (int index = 0; index < system_count; index++) {
+    auto family = families_[index];
+    family_to_index_[family] = index;
+    levels_[index] = family_levels[family];
+    while (level_offsets_.size() <= levels_[index]) {
+      level_offsets_.push_back(index);
+    }
+  }
+  level_offsets_.push_back(system_count);
+
+  successor_offsets_.assign(1, 0);
+  successors_.clear();
+  in_degrees_.resize(system_count);
+  for (int index = 0; index < system_count; index++) {
+    auto& system = systems[families_[index]];
+    in_degrees_[index] = static_cast<int>(system->dependencies_.size());
+    auto begin = successors_.size();
+    for (auto& next_family : system->next_) {
+      successors_.push_back(family_to_index_[next_family]);
+    }
+    std::sort(successors_.begin() + begin, successors_.end());
+    successor_offsets_.push_back(static_cast<int>(successors_.size()));
+  }
+
+  // a sync point after the last level would not hold anything back, the frame ends there anyway
+  segment_offsets_.assign(1, 0);
+  segments_.resize(system_count);
+  for (int level = 0; level < level_count(); level++) {
+    bool sync_point = false;
+    for (int index = level_offsets_[level]; index < level_offsets_[level + 1]; index++) {
+      segments_[index] = static_cast<int>(segment_offsets_.size()) - 1;
+      sync_point = sync_point || systems[families_[index]]->sync_point_;
+    }
+    if (sync_point && level + 1 < level_count()) {
+      segment_offsets_.push_back(level_offsets_[level + 1]);
+    }
+  }
+  segment_offsets_.push_back(system_count);
+}
+
+}  // namespace gs
@@ -0,0 +1,420 @@
+/**
+ * Copyright 2026 by GallenShao, All Rights Reserved.
+ *
+ * snapshot.cpp
+ *
+ *  Created on: 2026.10.17
+ *  Author: gallenshao
+ */
+
+#include "snapshot.h"
+#include "archetype.h"
+#include "sparse_set.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace gs {
+
+namespace {
+
+const char SNAPSHOT_MAGIC[8] = {'G', 'S', 'E', 'C', 'S', 'S', 'N', 'P'};
+// chunks start on a page boundary of the file, so that the mapped ones are aligned and can be shared
+const size_t SNAPSHOT_PAGE_SIZE = 4096;
+
+struct Header {
+  char magic[8];
+  uint32_t version;
+  uint32_t chunk_alignment;
+  uint64_t chunk_size;
+  uint64_t tick;
+  uint32_t component_count;
+  uint32_t slot_count;
+  uint32_t archetype_count;
+  uint32_t sparse_count;
+  uint32_t free_count;
+  uint32_t reserved;
+  // file offset of the first chunk
+  uint64_t chunks_offset;
+};
+
+// followed by the name, padded to 8 bytes
+struct ComponentRecord {
+  uint32_t size;
+  uint32_t align;
+  uint32_t name_length;
+  uint32_t reserved;
+};
+
+// followed by the component index of each column, padded to 8 bytes
+struct ArchetypeRecord {
+  uint32_t column_count;
+  uint32_t chunk_count;
+  uint64_t size;
+  uint64_t chunk_bytes;
+  uint32_t chunk_capacity;
+  uint32_t reserved;
+  // relative to Header::chunks_offset
+  uint64_t chunks_offset;
+};
+
+// followed by the entities and the components, each padded to 8 bytes
+struct SparseRecord {
+  uint32_t component;
+  uint32_t reserved;
+  uint64_t size;
+};
+
+size_t AlignUp(size_t value, size_t align) {
+  return (value + align - 1) / align * align;
+}
+
+class Writer {
+ public:
+  template <typename T>
+  void Put(const T& value) {
+    PutBytes(&value, sizeof(T));
+  }
+  void PutBytes(const void* data, size_t size) {
+    auto begin = static_cast<const uint8_t*>(data);
+    bytes_.insert(bytes_.end(), begin, begin + size);
+  }
+  void Align(size_t align) { bytes_.resize(AlignUp(bytes_.size(), align), 0); }
+
+  std::vector<uint8_t>& bytes() { return bytes_; }
+
+ private:
+  std::vector<uint8_t> bytes_;
+};
+
+// bounds-checked view of the mapped file, every read fails once one of them is out of range
+class Reader {
+ public:
+  Reader(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+  template <typename T>
+  const T* Take(size_t count = 1) {
+    auto bytes = sizeof(T) * count;
+    if (failed_ || offset_ + bytes > size_) {
+      failed_ = true;
+      return nullptr;
+    }
+    auto result = reinterpret_cast<const T*>(data_ + offset_);
+    offset_ += bytes;
+    return result;
+  }
+  void Align(size_t align) { offset_ = AlignUp(offset_, align); }
+
+  bool failed() const { return failed_; }
+
+ private:
+  const uint8_t* data_;
+  size_t size_;
+  size_t offset_ = 0;
+  bool failed_ = false;
+};
+
+// column offsets of a chunk laid out like Archetype does, for the columns in the given order
+struct ChunkLayout {
+  ChunkLayout(const std::vector<const ComponentRecord*>& columns, int capacity) {
+    auto rows = AlignUp(capacity, MAX_BATCH_SIZE);
+    size_t offset = sizeof(Entity) * rows;
+    for (auto column : columns) {
+      offset = AlignUp(offset, CHUNK_ALIGNMENT);
+      column_offsets.push_back(offset);
+      offset += column->size * rows;
+    }
+    ticks_offset = AlignUp(offset, alignof(Tick));
+  }
+
+  std::vector<size_t> column_offsets;
+  size_t ticks_offset;
+};
+
+}  // namespace
+
+bool Snapshot::Save(const EntityManager& manager, const std::string& path) {
+  // components present in the world, indexed in the file by order of appearance
+  std::vector<int> component_index(MAX_COMPONENT_COUNT, -1);
+  std::vector<ComponentBase::Family> components;
+  auto use = [&component_index, &components](ComponentBase::Family family) {
+    if (component_index[family] < 0) {
+      component_index[family] = static_cast<int>(components.size());
+      components.push_back(family);
+    }
+    return ComponentBase::GetInfo(family).trivially_copyable;
+  };
+
+  std::vector<const Archetype*> archetypes;
+  for (auto& archetype : manager.archetypes_) {
+    if (archetype->size() == 0) {
+      continue;
+    }
+    for (auto family : archetype->families()) {
+      if (!use(family)) {
+        return false;
+      }
+    }
+    archetypes.push_back(archetype.get());
+  }
+  std::vector<const SparseSet*> sparse_sets;
+  for (auto& set : manager.sparse_sets_) {
+    if (set != nullptr && set->size() > 0) {
+      if (!use(set->family())) {
+        return false;
+      }
+      sparse_sets.push_back(set.get());
+    }
+  }
+
+  Writer writer;
+  Header header = {};
+  std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+  header.version = SNAPSHOT_VERSION;
+  header.chunk_alignment = CHUNK_ALIGNMENT;
+  header.chunk_size = CHUNK_SIZE;
+  header.tick = manager.tick_;
+  header.component_count = static_cast<uint32_t>(components.size());
+  header.slot_count = static_cast<uint32_t>(manager.locations_.size());
+  header.archetype_count = static_cast<uint32_t>(archetypes.size());
+  header.sparse_count = static_cast<uint32_t>(sparse_sets.size());
+  header.free_count = static_cast<uint32_t>(manager.free_list_.size());
+  writer.Put(header);
+
+  for (auto family : components) {
+    auto& info = ComponentBase::GetInfo(family);
+    ComponentRecord record = {};
+    record.size = static_cast<uint32_t>(info.size);
+    record.align = static_cast<uint32_t>(info.align);
+    record.name_length = static_cast<uint32_t>(std::strlen(info.name));
+    writer.Put(record);
+    writer.PutBytes(info.name, record.name_length);
+    writer.Align(8);
+  }
+
+  for (auto& location : manager.locations_) {
+    writer.Put(location.version);
+  }
+  writer.Align(8);
+  writer.PutBytes(manager.free_list_.data(), sizeof(Entity::Index) * manager.free_list_.size());
+  writer.Align(8);
+
+  uint64_t chunks_offset = 0;
+  for (auto archetype : archetypes) {
+    ArchetypeRecord record = {};
+    record.column_count = static_cast<uint32_t>(archetype->families().size());
+    record.chunk_count = static_cast<uint32_t>(archetype->chunks().size());
+    record.size = archetype->size();
+    record.chunk_bytes = archetype->chunk_bytes_;
+    record.chunk_capacity = archetype->chunk_capacity();
+    record.chunks_offset = chunks_offset;
+    writer.Put(record);
+    for (auto family : archetype->families()) {
+      writer.Put(static_cast<uint32_t>(component_index[family]));
+    }
+    writer.Align(8);
+    chunks_offset += record.chunk_bytes * record.chunk_count;
+  }
+
+  for (auto set : sparse_sets) {
+    auto& info = ComponentBase::GetInfo(set->family());
+    SparseRecord record = {};
+    record.component = static_cast<uint32_t>(component_index[set->family()]);
+    record.size = set->size();
+    writer.Put(record);
+    writer.PutBytes(set->entities().data(), sizeof(Entity) * set->size());
+    for (size_t index = 0; index < set->size(); index++) {
+      writer.PutBytes(set->At(index), info.size);
+    }
+    writer.Align(8);
+  }
+
+  writer.Align(SNAPSHOT_PAGE_SIZE);
+  reinterpret_cast<Header*>(writer.bytes().data())->chunks_offset = writer.bytes().size();
+
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  out.write(reinterpret_cast<const char*>(writer.bytes().data()), writer.bytes().size());
+  for (auto archetype : archetypes) {
+    for (auto& chunk : archetype->chunks()) {
+      out.write(reinterpret_cast<const char*>(chunk.data), archetype->chunk_bytes_);
+    }
+  }
+  return static_cast<bool>(out);
+}
+
+bool Snapshot::Load(EntityManager& manager, const std::string& path) {
+  assert(manager.Size() == 0);
+  auto fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat status = {};
+  void* data = MAP_FAILED;
+  if (fstat(fd, &status) == 0 && static_cast<size_t>(status.st_size) >= sizeof(Header)) {
+    // private pages are copied on the first write, the file is never modified
+    data = mmap(nullptr, status.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  }
+  close(fd);
+  if (data == MAP_FAILED) {
+    return false;
+  }
+  // owns the mapping from here on, it is released with the allocator on failure
+  auto allocator = std::make_shared<MappedChunkAllocator>(data, status.st_size, manager.allocator_);
+  auto original_allocator = manager.allocator_;
+  auto fail = [&manager, &original_allocator]() {
+    manager.Reset(original_allocator);
+    return false;
+  };
+
+  Reader reader(allocator->data(), allocator->size());
+  auto header = reader.Take<Header>();
+  if (header == nullptr || std::memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(header->magic)) != 0 ||
+      header->version != SNAPSHOT_VERSION || header->chunk_alignment != CHUNK_ALIGNMENT ||
+      header->chunk_size != CHUNK_SIZE || header->chunks_offset % SNAPSHOT_PAGE_SIZE != 0) {
+    return false;
+  }
+
+  std::vector<ComponentBase::Family> families;
+  std::vector<const ComponentRecord*> records;
+  for (uint32_t index = 0; index < header->component_count; index++) {
+    auto record = reader.Take<ComponentRecord>();
+    auto name = record != nullptr ? reader.Take<char>(record->name_length) : nullptr;
+    reader.Align(8);
+    if (name == nullptr) {
+      return false;
+    }
+    auto family = ComponentBase::FindFamily(std::string(name, record->name_length).c_str());
+    if (family < 0) {
+      return false;
+    }
+    auto& info = ComponentBase::GetInfo(family);
+    if (info.size != record->size || info.align != record->align || !info.trivially_copyable) {
+      return false;
+    }
+    families.push_back(family);
+    records.push_back(record);
+  }
+
+  auto versions = reader.Take<Entity::Version>(header->slot_count);
+  reader.Align(8);
+  auto free_list = reader.Take<Entity::Index>(header->free_count);
+  reader.Align(8);
+  if (reader.failed()) {
+    return false;
+  }
+
+  manager.Reset(allocator);
+  manager.tick_ = header->tick;
+  manager.locations_.resize(header->slot_count);
+  for (uint32_t index = 0; index < header->slot_count; index++) {
+    manager.locations_[index].version = versions[index];
+  }
+
+  auto chunks = allocator->data() + header->chunks_offset;
+  for (uint32_t index = 0; index < header->archetype_count; index++) {
+    auto record = reader.Take<ArchetypeRecord>();
+    auto columns = record != nullptr ? reader.Take<uint32_t>(record->column_count) : nullptr;
+    reader.Align(8);
+    if (columns == nullptr || record->chunk_capacity == 0 ||
+        record->chunk_count != (record->size + record->chunk_capacity - 1) / record->chunk_capacity ||
+        header->chunks_offset + record->chunks_offset + record->chunk_bytes * record->chunk_count > allocator->size()) {
+      return fail();
+    }
+
+    ComponentMask mask;
+    std::vector<const ComponentRecord*> column_records;
+    for (uint32_t column = 0; column < record->column_count; column++) {
+      if (columns[column] >= families.size() || ComponentBase::GetInfo(families[columns[column]]).sparse) {
+        return fail();
+      }
+      mask.set(families[columns[column]]);
+      column_records.push_back(records[columns[column]]);
+    }
+    auto archetype = manager.GetArchetype(mask);
+    if (archetype->families().size() != record->column_count || archetype->chunk_capacity() != record->chunk_capacity) {
+      return fail();
+    }
+
+    // the columns are laid out by family, they line up if the families kept their relative order
+    bool mapped = record->chunk_bytes == archetype->chunk_bytes_;
+    for (uint32_t column = 0; column < record->column_count; column++) {
+      mapped = mapped && archetype->families()[column] == families[columns[column]];
+    }
+    ChunkLayout layout(column_records, record->chunk_capacity);
+
+    auto remaining = record->size;
+    for (uint32_t chunk_index = 0; chunk_index < record->chunk_count; chunk_index++) {
+      auto source = chunks + record->chunks_offset + record->chunk_bytes * chunk_index;
+      Chunk chunk;
+      chunk.size = static_cast<int>(std::min<uint64_t>(remaining, record->chunk_capacity));
+      remaining -= chunk.size;
+      if (mapped) {
+        chunk.data = source;
+      } else {
+        chunk.data = static_cast<uint8_t*>(allocator->Allocate(archetype->chunk_bytes_));
+        std::memcpy(chunk.data, source, sizeof(Entity) * chunk.size);
+        for (uint32_t column = 0; column < record->column_count; column++) {
+          auto local = archetype->column_index_[families[columns[column]]];
+          std::memcpy(chunk.data + archetype->column_offsets_[local], source + layout.column_offsets[column],
+                      column_records[column]->size * chunk.size);
+          archetype->Ticks(chunk)[local] = reinterpret_cast<const Tick*>(source + layout.ticks_offset)[column];
+        }
+      }
+      archetype->chunks_.push_back(chunk);
+      archetype->size_ += chunk.size;
+    }
+  }
+  if (!manager.Relink(free_list, header->free_count)) {
+    return fail();
+  }
+
+  for (uint32_t index = 0; index < header->sparse_count; index++) {
+    auto record = reader.Take<SparseRecord>();
+    if (record == nullptr || record->component >= families.size() ||
+        !ComponentBase::GetInfo(families[record->component]).sparse) {
+      return fail();
+    }
+    auto component_size = records[record->component]->size;
+    auto entities = reader.Take<Entity>(record->size);
+    reader.Align(8);
+    auto components = reader.Take<uint8_t>(component_size * record->size);
+    reader.Align(8);
+    if (components == nullptr) {
+      return fail();
+    }
+    auto& set = manager.GetSparseSet(families[record->component]);
+    for (size_t row = 0; row < record->size; row++) {
+      if (!manager.Valid(entities[row]) || set.Has(entities[row])) {
+        return fail();
+      }
+      std::memcpy(set.Add(entities[row]), components + component_size * row, component_size);
+    }
+  }
+
+  return true;
+}
+
+MappedChunkAllocator::MappedChunkAllocator(void* data, size_t size, std::shared_ptr<ChunkAllocator> allocator)
+    : data_(static_cast<uint8_t*>(data)), size_(size), allocator_(std::move(allocator)) {}
+
+MappedChunkAllocator::~MappedChunkAllocator() {
+  munmap(data_, size_);
+}
+
+void* MappedChunkAllocator::Allocate(size_t size) {
+  return allocator_->Allocate(size);
+}
+
+void MappedChunkAllocator::Deallocate(void* ptr, size_t size) {
+  auto bytes = static_cast<uint8_t*>(ptr);
+  if (bytes < data_ || bytes >= data_ + size_) {
+    allocator_->Deallocate(ptr, size);
+  }
+}
+
+}  // namespace gs
@@ -0,0 +1,68 @@
+/**
+ * Copyright 2026 by GallenShao, All Rights Reserved.
+ *
+ * sparse_set.cpp
+ *
+ *  Created on: 2026.10.17
+ *  Author: gallenshao
+ */
+
+#include "sparse_set.h"
+#include <algorithm>
+#include <cassert>
+
+namespace gs {
+
+SparseSet::SparseSet(ComponentBase::Family family, ChunkAllocator& allocator)
+    : family_(family), info_(ComponentBase::GetInfo(family)), allocator_(allocator) {
+  assert(info_.align <= CHUNK_ALIGNMENT);
+  page_bytes_ = std::max(info_.size, static_cast<size_t>(CHUNK_SIZE));
+  page_capacity_ = page_bytes_ / info_.size;
+}
+
+SparseSet::~SparseSet() {
+  for (size_t index = 0; index < entities_.size(); index++) {
+    info_.destroy(At(index));
+  }
+  for (auto page : pages_) {
+    allocator_.Deallocate(page, page_bytes_);
+  }
+}
+
+void* SparseSet::Add(Entity entity) {
+  assert(!Has(entity));
+  auto index = entities_.size();
+  if (index == pages_.size() * page_capacity_) {
+    pages_.push_back(static_cast<uint8_t*>(allocator_.Allocate(page_bytes_)));
+  }
+  if (sparse_.size() <= entity.index()) {
+    sparse_.resize(entity.index() + 1, INVALID_INDEX);
+  }
+  sparse_[entity.index()] = static_cast<uint32_t>(index);
+  entities_.push_back(entity);
+  return At(index);
+}
+
+void SparseSet::Remove(Entity entity) {
+  if (!Has(entity)) {
+    return;
+  }
+  auto index = sparse_[entity.index()];
+  auto last = entities_.size() - 1;
+  info_.destroy(At(index));
+  if (index != last) {
+    info_.relocate(At(index), At(last));
+    entities_[index] = entities_[last];
+    sparse_[entities_[index].index()] = index;
+  }
+  sparse_[entity.index()] = INVALID_INDEX;
+  entities_.pop_back();
+
+  // keep one spare page, so that toggling around a page boundary does not allocate
+  if (pages_.size() > 1 && last <= (pages_.size() - 2) * page_capacity_) {
+    allocator_.Deallocate(pages_.back(), page_bytes_);
+    pages_.pop_back();
+  }
+}
+
+}  // namespace gs
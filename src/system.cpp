@@ -1,28 +1,84 @@
 #include "system.hpp"
+#include "thread_cache.h"
+#include <algorithm>
+#include <chrono>
+#include <typeinfo>
+
+#if defined(__GNUG__)
+#include <cxxabi.h>
+#include <cstdlib>
+#endif
 
 namespace gs {
 
 BaseSystem::Family BaseSystem::family_count_ = 0;
 SystemThreadBase::Family SystemThreadBase::family_count_ = 0;
 
+void BaseSystem::ParallelFor(int count, const std::function<void(int)>& job) {
+  if (traverser_ != nullptr && count > 1) {
+    // the helper threads write with the tick of this system
+    auto tick = EntityManager::thread_tick();
+    traverser_->ParallelFor(count, [tick, &job](int index) {
+      auto previous = EntityManager::SetThreadTick(tick);
+      job(index);
+      EntityManager::SetThreadTick(previous);
+    });
+  } else {
+    for (int index = 0; index < count; index++) {
+      job(index);
+    }
+  }
+}
+
+std::string BaseSystem::GetName() {
+  std::string name = typeid(*this).name();
+#if defined(__GNUG__)
+  int status = 0;
+  auto demangled = abi::__cxa_demangle(name.c_str(), nullptr, nullptr, &status);
+  if (status == 0 && demangled != nullptr) {
+    name = demangled;
+  }
+  std::free(demangled);
+#endif
+  return name;
+}
+
+CommandBuffer& BaseSystem::Commands() {
+  assert(manager_ != nullptr);
+  return manager_->GetThreadContext().commands;
+}
+
+LinearArena& BaseSystem::FrameArena() {
+  assert(manager_ != nullptr);
+  return manager_->GetThreadContext().frame_arena;
+}
+
+bool BaseSystem::ConflictsWith(const BaseSystem& other) const {
+  return (write_mask_ & other.access_mask_).any() || (access_mask_ & other.write_mask_).any();
+}
+
 SystemGroupBuilder SystemGroup::AddSystem(BaseSystem::Family family, std::shared_ptr<BaseSystem> system) {
   assert(editable_);
   if (all_systems_.size() <= family) {
     all_systems_.resize(family + 1);
   }
   assert(all_systems_[family] == nullptr);
+  auto candidates = all_system_families_;
   all_systems_[family] = std::move(system);
-  all_systems_mask_.set(family);
+  all_system_families_.insert(family);
   start_node_families_.insert(family);
 
   std::set<BaseSystem::Family> current;
   current.insert(family);
+  InferDependencies(current, candidates);
   return {this, current};
 }
 
 SystemGroupBuilder SystemGroup::AddSystemGroup(SystemGroup& group) {
   assert(!group.all_systems_.empty());
-  assert((all_systems_mask_ & group.all_systems_mask_).none());
+  for (auto& family : group.all_system_families_) {
+    assert(!Contains(family));
+  }
   assert(group.editable_);
   assert(editable_);
   group.editable_ = false;
@@ -30,6 +86,7 @@ SystemGroupBuilder SystemGroup::AddSystemGroup(SystemGroup& group) {
   if (all_systems_.size() < group.all_systems_.size()) {
     all_systems_.resize(group.all_systems_.size());
   }
+  auto candidates = all_system_families_;
   std::set<BaseSystem::Family> current;
   for (int family = 0; family < group.all_systems_.size(); family++) {
     auto& system = group.all_systems_[family];
@@ -39,7 +96,7 @@ SystemGroupBuilder SystemGroup::AddSystemGroup(SystemGroup& group) {
       current.insert(family);
     }
   }
-  all_systems_mask_ |= group.all_systems_mask_;
+  all_system_families_.insert(group.all_system_families_.begin(), group.all_system_families_.end());
 
   if (thread_creator_.size() < group.thread_creator_.size()) {
     thread_creator_.resize(group.thread_creator_.size());
@@ -52,21 +109,93 @@ SystemGroupBuilder SystemGroup::AddSystemGroup(SystemGroup& group) {
   }
 
   start_node_families_.insert(group.start_node_families_.begin(), group.start_node_families_.end());
+  InferDependencies(current, candidates);
   return {this, current};
 }
 
+void SystemGroup::AddDependency(BaseSystem::Family family, BaseSystem::Family dependency_family) {
+  all_systems_[family]->dependencies_.insert(dependency_family);
+  all_systems_[dependency_family]->next_.insert(family);
+  start_node_families_.erase(family);
+}
+
+bool SystemGroup::Contains(BaseSystem::Family family) const {
+  return family >= 0 && family < all_systems_.size() && all_systems_[family] != nullptr;
+}
+
+void SystemGroup::InferDependencies(const std::set<BaseSystem::Family>& families,
+                                    const std::set<BaseSystem::Family>& candidates) {
+  for (auto& family : families) {
+    auto& system = all_systems_[family];
+    if (system->access_mask_.none()) {
+      continue;
+    }
+
+    std::vector<BaseSystem::Family> conflicts;
+    for (auto& other : candidates) {
+      if (system->ConflictsWith(*all_systems_[other])) {
+        conflicts.push_back(other);
+      }
+    }
+
+    // only keep the edges which are not implied by other edges
+    for (auto& dependency_family : conflicts) {
+      bool implied = Reachable(dependency_family, family);
+      for (auto& other : conflicts) {
+        implied = implied || (other != dependency_family && Reachable(dependency_family, other));
+      }
+      if (!implied) {
+        AddDependency(family, dependency_family);
+      }
+    }
+  }
+}
+
+bool SystemGroup::Reachable(BaseSystem::Family from, BaseSystem::Family to) const {
+  std::vector<bool> visited(all_systems_.size(), false);
+  std::vector<BaseSystem::Family> stack = {from};
+  while (!stack.empty()) {
+    auto family = stack.back();
+    stack.pop_back();
+    for (auto& next_family : all_systems_[family]->next_) {
+      if (next_family == to) {
+        return true;
+      }
+      if (!visited[next_family]) {
+        visited[next_family] = true;
+        stack.push_back(next_family);
+      }
+    }
+  }
+  return false;
+}
+
+SystemGroupBuilder SystemGroupBuilder::WithTickRate(double rate) {
+  assert(rate > 0);
+  for (auto& family : current_) {
+    auto& system = group_->all_systems_[family];
+    assert(system != nullptr);
+    if (system->tick_rate_ == 0) {
+      system->tick_rate_ = rate;
+    }
+  }
+  return *this;
+}
+
 SystemGroupBuilderItem SystemGroupBuilder::WhichDependsOn(SystemGroup& group) {
   gs::SystemGroupBuilderItem item = {group_, current_};
   return item.And(group);
 }
 
 SystemGroupBuilderItem SystemGroupBuilderItem::And(SystemGroup& group) {
-  assert(((group_->all_systems_mask_ & group.all_systems_mask_) ^ group.all_systems_mask_).none());
+  for (auto& family : group.all_system_families_) {
+    assert(group_->Contains(family));
+  }
 
   for (auto& family : current_) {
-    assert(group.all_systems_mask_.test(family) == false);
+    assert(!group.Contains(family));
     auto current_system = group_->all_systems_[family];
-    current_system->dependencies_ |= group.all_systems_mask_;
+    current_system->dependencies_.insert(group.all_system_families_.begin(), group.all_system_families_.end());
     group_->start_node_families_.erase(family);
   }
 
@@ -81,73 +210,440 @@ SystemGroupBuilderItem SystemGroupBuilderItem::And(SystemGroup& group) {
   return *this;
 }
 
-void SystemManager::Reset() {
-  std::lock_guard<std::mutex> autoLock(locker);
-  runnable_systems_.clear();
-  runnable_systems_.assign(start_node_families_.begin(), start_node_families_.end());
-  system_finished_.reset();
+void SystemManager::Compile() {
+  if (!editable_) {
+    return;
+  }
+  editable_ = false;
+
+  if (pipelined_) {
+    SplitPipelineStages();
+  }
+  schedule_.Build(all_systems_);
+  runnable_systems_ = std::make_unique<PrioritySet>(schedule_.size());
+  run_times_.assign(schedule_.size(), 0);
+  remaining_dependencies_ = std::vector<std::atomic<int>>(schedule_.size());
+  segment_remaining_ = std::vector<std::atomic<int>>(schedule_.segment_count());
+  ready_times_ = std::vector<std::atomic<int64_t>>(schedule_.size());
+  due_.assign(schedule_.size(), 1);
+  tick_stride_ = 2 * schedule_.size() + 2;
+  UpdatePriorities();
+  for (auto& system : all_systems_) {
+    if (system != nullptr) {
+      system->traverser_ = system_traverser_.get();
+      system->manager_ = this;
+      if (profiler_) {
+        profiler_->SetName(system->GetFamily(), system->GetName());
+      }
+    }
+  }
+}
+
+void SystemManager::SplitPipelineStages() {
+  std::vector<bool> late(all_systems_.size(), false);
+  std::vector<BaseSystem::Family> pending;
+  for (auto& family : all_system_families_) {
+    if (all_systems_[family]->pipeline_boundary_) {
+      late[family] = true;
+      pending.push_back(family);
+    }
+  }
+  while (!pending.empty()) {
+    auto family = pending.back();
+    pending.pop_back();
+    for (auto& next_family : all_systems_[family]->next_) {
+      if (!late[next_family]) {
+        late[next_family] = true;
+        pending.push_back(next_family);
+      }
+    }
+  }
+
+  // the late systems each early system is ordered before, including the transitive orders whose direct edge was
+  // never added by `InferDependencies`
+  std::vector<std::vector<BaseSystem::Family>> ordered_before(all_systems_.size());
+  for (auto& family : all_system_families_) {
+    if (late[family]) {
+      continue;
+    }
+    std::vector<bool> visited(all_systems_.size(), false);
+    pending = {family};
+    while (!pending.empty()) {
+      auto current = pending.back();
+      pending.pop_back();
+      for (auto& next_family : all_systems_[current]->next_) {
+        if (!visited[next_family]) {
+          visited[next_family] = true;
+          pending.push_back(next_family);
+          if (late[next_family]) {
+            ordered_before[family].push_back(next_family);
+          }
+        }
+      }
+    }
+  }
+
+  // the late systems run on the published copies, only an Access conflict still needs the order
+  for (auto& family : all_system_families_) {
+    auto& system = all_systems_[family];
+    if (late[family]) {
+      continue;
+    }
+    for (auto it = system->next_.begin(); it != system->next_.end();) {
+      auto& next = all_systems_[*it];
+      if (late[*it] && !system->ConflictsWith(*next)) {
+        next->dependencies_.erase(family);
+        it = system->next_.erase(it);
+      } else {
+        it++;
+      }
+    }
+  }
+
+  // the path which implied a conflicting order may just have been cut
+  for (auto& family : all_system_families_) {
+    auto& system = all_systems_[family];
+    for (auto& late_family : ordered_before[family]) {
+      if (system->ConflictsWith(*all_systems_[late_family]) && !Reachable(family, late_family)) {
+        AddDependency(late_family, family);
+      }
+    }
+  }
+}
+
+void SystemManager::SetPriority(Priority priority) {
+  priority_ = priority;
+  measure_run_times_ = priority == MEASURED_CRITICAL_PATH;
+  if (!editable_) {
+    UpdatePriorities();
+  }
+}
+
+void SystemManager::UpdatePriorities() {
+  // the schedule is in topological order, the successors of an index come after it
+  std::vector<double> path(schedule_.size(), 0);
+  for (int index = schedule_.size() - 1; index >= 0 && priority_ != LEVEL; index--) {
+    double longest = 0;
+    for (auto it = schedule_.SuccessorsBegin(index); it != schedule_.SuccessorsEnd(index); it++) {
+      longest = std::max(longest, path[*it]);
+    }
+    path[index] = (measure_run_times_ ? run_times_[index] : 1) + longest;
+  }
+
+  index_of_rank_.resize(schedule_.size());
+  for (int index = 0; index < schedule_.size(); index++) {
+    index_of_rank_[index] = index;
+  }
+  std::stable_sort(index_of_rank_.begin(), index_of_rank_.end(), [&path](int a, int b) { return path[a] > path[b]; });
+  rank_of_index_.resize(schedule_.size());
+  for (int rank = 0; rank < schedule_.size(); rank++) {
+    rank_of_index_[index_of_rank_[rank]] = rank;
+  }
 }
 
-bool SystemManager::GetNext(std::shared_ptr<BaseSystem>& next) {
-  std::lock_guard<std::mutex> autoLock(locker);
-  if (runnable_systems_.empty()) {
-    next = nullptr;
-    return all_systems_mask_ != system_finished_;
+bool SystemManager::PopRunnable(int& index) {
+  int rank;
+  if (!runnable_systems_->Pop(rank)) {
+    return false;
   }
-  next = all_systems_[runnable_systems_.front()];
-  runnable_systems_.pop_front();
+  index = index_of_rank_[rank];
   return true;
 }
 
+void SystemManager::RecordRunTime(int index, int64_t nanoseconds) {
+  // the first frame seeds the average
+  auto& run_time = run_times_[index];
+  run_time = run_time == 0 ? nanoseconds : run_time * 0.8 + nanoseconds * 0.2;
+}
+
+void SystemManager::Reset() {
+  Compile();
+
+  int index;
+  while (PopRunnable(index)) {
+  }
+  if (measure_run_times_) {
+    UpdatePriorities();
+  }
+
+  // systems after the first sync point also wait for their sync point
+  for (index = 0; index < schedule_.size(); index++) {
+    auto sync_points = schedule_.Segment(index) > 0 ? 1 : 0;
+    remaining_dependencies_[index].store(schedule_.InDegree(index) + sync_points, std::memory_order_relaxed);
+  }
+  auto& segment_offsets = schedule_.segment_offsets();
+  for (int segment = 0; segment < schedule_.segment_count(); segment++) {
+    segment_remaining_[segment].store(segment_offsets[segment + 1] - segment_offsets[segment],
+                                      std::memory_order_relaxed);
+  }
+  auto now = profiler_ ? profiler_->Now() : 0;
+  for (index = 0; index < schedule_.root_count(); index++) {
+    ready_times_[index].store(now, std::memory_order_relaxed);
+    PushRunnable(index);
+  }
+  finished_count_.store(0);
+}
+
+bool SystemManager::GetNext(BaseSystem*& next) {
+  int index;
+  while (PopRunnable(index)) {
+    if (due_[index]) {
+      next = all_systems_[schedule_.FamilyOf(index)].get();
+      return true;
+    }
+    // never handed to the traverser, its successors are released right away
+    OnSystemFinished(schedule_.FamilyOf(index));
+  }
+  next = nullptr;
+  return finished_count_.load(std::memory_order_acquire) != schedule_.size();
+}
+
 void SystemManager::OnSystemFinished(BaseSystem::Family family) {
-  std::lock_guard<std::mutex> autoLock(locker);
-  auto system = all_systems_[family];
-  if (system == nullptr) {
+  if (family >= all_systems_.size() || all_systems_[family] == nullptr) {
     return;
   }
 
-  system_finished_[family] = true;
-  for (auto& next_family : system->next_) {
-    auto next_system = all_systems_[next_family];
-    assert(next_system != nullptr);
+  // the last finished dependency releases the successor
+  auto index = schedule_.IndexOf(family);
+  for (auto it = schedule_.SuccessorsBegin(index); it != schedule_.SuccessorsEnd(index); it++) {
+    if (remaining_dependencies_[*it].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      if (profiler_) {
+        ready_times_[*it].store(profiler_->Now(), std::memory_order_relaxed);
+      }
+      PushRunnable(*it);
+    }
+  }
 
-    if ((system_finished_ & next_system->dependencies_) == next_system->dependencies_) {
-      runnable_systems_.push_back(next_family);
+  // the segment is done and the next one has not started yet, no system is running
+  auto segment = schedule_.Segment(index);
+  if (segment + 1 < schedule_.segment_count() &&
+      segment_remaining_[segment].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    auto& segment_offsets = schedule_.segment_offsets();
+    PlaybackCommandBuffers(PlaybackTick(segment_offsets[segment + 1]));
+    for (auto next = segment_offsets[segment + 1]; next < segment_offsets[segment + 2]; next++) {
+      if (remaining_dependencies_[next].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        if (profiler_) {
+          ready_times_[next].store(profiler_->Now(), std::memory_order_relaxed);
+        }
+        PushRunnable(next);
+      }
     }
   }
+  finished_count_.fetch_add(1, std::memory_order_release);
 }
 
-void SystemManager::OnSystemTryAgainLater(BaseSystem::Family family) {
-  std::lock_guard<std::mutex> autoLock(locker);
-  runnable_systems_.push_back(family);
+SystemManager::SystemManager() : id_(ThreadLocalCache<ThreadContext>::NewOwner()) {}
+
+template <typename F>
+void SystemManager::RunSystem(BaseSystem& system, F&& func) {
+  auto previous = EntityManager::SetThreadTick(SystemTick(schedule_.IndexOf(system.GetFamily())));
+  func();
+  EntityManager::SetThreadTick(previous);
+}
+
+void SystemManager::BeginFrame() {
+  ResetFrameArenas();
+  frame_++;
+}
+
+void SystemManager::EndFrame() {
+  PlaybackCommandBuffers(PlaybackTick(schedule_.size()));
+  // writes between two frames are newer than every system tick of this one
+  entities_->SetTick(PlaybackTick(schedule_.size()));
+  for (auto& publish : publishers_) {
+    publish(*entities_);
+  }
+  entities_ = nullptr;
 }
 
 void SystemManager::Configure(EntityManager& entityManager) {
   Reset();
+  std::fill(due_.begin(), due_.end(), 1);
+  BeginFrame();
+  entities_ = &entityManager;
   system_traverser_->Traverse([this, &entityManager](std::shared_ptr<BaseSystem>& system) {
-    system->Configure(entityManager);
+    RunSystem(*system, [&system, &entityManager]() { system->Configure(entityManager); });
     OnSystemFinished(system->GetFamily());
   });
+  EndFrame();
 }
 
 void SystemManager::Update(EntityManager& entityManager) {
+  Compile();
+  for (int index = 0; index < schedule_.size(); index++) {
+    auto& system = all_systems_[schedule_.FamilyOf(index)];
+    system->delta_time_ = system->tick_rate_ > 0 ? 1 / system->tick_rate_ : 0;
+    due_[index] = 1;
+  }
+  RunFrame(entityManager);
+}
+
+void SystemManager::Update(EntityManager& entityManager, double dt) {
+  Compile();
+  int passes = 0;
+  for (auto& system : all_systems_) {
+    if (system == nullptr) {
+      continue;
+    }
+    if (system->tick_rate_ > 0) {
+      // tolerate the rounding of dt, 1 / 60 is two steps of 1 / 120
+      system->accumulator_ += dt;
+      auto steps = static_cast<int>(system->accumulator_ * system->tick_rate_ + 1e-6);
+      system->accumulator_ = std::max(system->accumulator_ - steps / system->tick_rate_, 0.0);
+      system->pending_steps_ = std::min(steps, max_catch_up_steps_);
+      system->delta_time_ = 1 / system->tick_rate_;
+    } else {
+      system->pending_steps_ = 1;
+      system->delta_time_ = dt;
+    }
+    passes = std::max(passes, system->pending_steps_);
+  }
+
+  // the steps of every system end with the last pass, so that the systems without a tick rate see the latest state
+  for (int pass = 0; pass < passes; pass++) {
+    for (int index = 0; index < schedule_.size(); index++) {
+      due_[index] = all_systems_[schedule_.FamilyOf(index)]->pending_steps_ >= passes - pass;
+    }
+    RunFrame(entityManager);
+  }
+}
+
+void SystemManager::RunFrame(EntityManager& entityManager) {
+  BeginFrame();
+  entities_ = &entityManager;
+  if (profiler_ == nullptr) {
+    Reset();
+    system_traverser_->Traverse([this, &entityManager](std::shared_ptr<BaseSystem>& system) {
+      auto start = measure_run_times_ ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+      RunSystem(*system, [&system, &entityManager]() {
+        system->Update(entityManager);
+        system->last_run_tick_ = EntityManager::thread_tick();
+      });
+      if (measure_run_times_) {
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        RecordRunTime(schedule_.IndexOf(system->GetFamily()),
+                      std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+      }
+      OnSystemFinished(system->GetFamily());
+    });
+    EndFrame();
+    return;
+  }
+
+  // the traverser runs `func` on the thread it picked for the system, so the events land in that thread's buffer
+  auto profiler = profiler_;
+  profiler->BeginFrame();
   Reset();
-  system_traverser_->Traverse([this, &entityManager](std::shared_ptr<BaseSystem>& system) {
-    system->Update(entityManager);
-    OnSystemFinished(system->GetFamily());
+  system_traverser_->Traverse([this, &entityManager, &profiler](std::shared_ptr<BaseSystem>& system) {
+    auto family = system->GetFamily();
+    auto ready = ready_times_[schedule_.IndexOf(family)].load(std::memory_order_relaxed);
+    auto start = profiler->Now();
+    RunSystem(*system, [&system, &entityManager]() {
+      system->Update(entityManager);
+      system->last_run_tick_ = EntityManager::thread_tick();
+    });
+    auto end = profiler->Now();
+    profiler->Record(family, ready, start, end);
+    if (measure_run_times_) {
+      RecordRunTime(schedule_.IndexOf(family), end - start);
+    }
+    OnSystemFinished(family);
   });
+  EndFrame();
+  profiler->Collect();
+}
+
+void SystemManager::SetAllocator(std::shared_ptr<ChunkAllocator> allocator) {
+  std::lock_guard<std::mutex> locker(thread_contexts_lock_);
+  allocator_ = std::move(allocator);
+}
+
+SystemManager::ThreadContext& SystemManager::GetThreadContext() {
+  auto cached = ThreadLocalCache<ThreadContext>::Get(id_);
+  if (cached != nullptr) {
+    return *cached;
+  }
+
+  // a thread only ever touches its own context, the lock only guards the list
+  std::lock_guard<std::mutex> locker(thread_contexts_lock_);
+  ThreadContext* context = nullptr;
+  for (auto& item : thread_contexts_) {
+    if (item->owner == std::this_thread::get_id()) {
+      context = item.get();
+    }
+  }
+  if (context == nullptr) {
+    thread_contexts_.push_back(std::make_unique<ThreadContext>(allocator_));
+    context = thread_contexts_.back().get();
+  }
+  ThreadLocalCache<ThreadContext>::Set(id_, context);
+  return *context;
+}
+
+void SystemManager::PlaybackCommandBuffers(Tick tick) {
+  std::lock_guard<std::mutex> locker(thread_contexts_lock_);
+  auto previous = EntityManager::SetThreadTick(tick);
+  for (auto& context : thread_contexts_) {
+    if (!context->commands.Empty()) {
+      context->commands.Playback(*entities_);
+    }
+  }
+  EntityManager::SetThreadTick(previous);
+}
+
+void SystemManager::ResetFrameArenas() {
+  std::lock_guard<std::mutex> locker(thread_contexts_lock_);
+  for (auto& context : thread_contexts_) {
+    context->frame_arena.Reset();
+  }
+}
+
+void SystemManager::SetProfiler(std::shared_ptr<FrameProfiler> profiler) {
+  profiler_ = std::move(profiler);
+  // systems added later are named by `Compile`
+  if (profiler_ && !editable_) {
+    for (auto& system : all_systems_) {
+      if (system != nullptr) {
+        profiler_->SetName(system->GetFamily(), system->GetName());
+      }
+    }
+  }
 }
 
 void SystemManager::SetMaxThreadCount(int count) {
   SetMaxThreadCount<DefaultThread>(count);
 }
 
+void SystemManager::SetThreadAffinity(const ThreadAffinity& affinity) {
+  SetThreadAffinity<DefaultThread>(affinity);
+}
+
 std::shared_ptr<BaseSystem> SystemManager::Get(BaseSystem::Family family) {
-  if (all_systems_mask_.test(family) && family < all_systems_.size()) {
+  if (Contains(family)) {
     return all_systems_[family];
   } else {
     return nullptr;
   }
 }
 
+void SystemTraverser::ParallelFor(int count, const std::function<void(int)>& job) {
+  for (int index = 0; index < count; index++) {
+    job(index);
+  }
+}
+
+void SystemTraverser::ParallelForState::Work() {
+  int index;
+  while ((index = next.fetch_add(1, std::memory_order_relaxed)) < count) {
+    job(index);
+    completed.fetch_add(1, std::memory_order_release);
+  }
+}
+
+void SystemTraverser::ParallelForState::Wait() {
+  while (completed.load(std::memory_order_acquire) < count) {
+    std::this_thread::yield();
+  }
+}
+
 }  // namespace gs
\ No newline at end of file
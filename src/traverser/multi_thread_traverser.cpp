@@ -8,11 +8,13 @@
  */
 
 #include "system.h"
+#include "wait_strategy.hpp"
+#include <algorithm>
 
 #define DEFAULT_default_thread_COUNT 4
 #define DEFAULT_custom_thread_COUNT 1
 
-gs::MultiThreadTraverser::MultiThreadTraverser() {
+gs::MultiThreadTraverser::MultiThreadTraverser(const WaitStrategy& wait_strategy) : wait_strategy_(wait_strategy) {
   MultiThreadTraverser::SetMaxThreadCount(DefaultThread::family(), DEFAULT_default_thread_COUNT);
 }
 
@@ -34,124 +36,203 @@ void gs::MultiThreadTraverser::Traverse(std::function<void(std::shared_ptr<gs::B
     return;
   }
 
-  std::shared_ptr<BaseSystem> current_system = nullptr;
-  while (true) {
-    if (current_system == nullptr) {
-      auto success = system_manager_->GetNext(current_system);
-      if (!success) {
+  traversing_manager_ = system_manager_.get();
+  traversing_func_ = &func;
+
+  auto system_count = system_manager_->all_systems_.size();
+  if (system_tasks_.size() != system_count) {
+    system_tasks_.resize(system_count);
+    for (int family = 0; family < system_count; family++) {
+      system_tasks_[family].traverser = this;
+      system_tasks_[family].family = family;
+    }
+  }
+
+  // systems which can not be posted wait in the queue of their thread family, the dispatcher only waits
+  // when nothing is runnable and wakes up whenever a thread finishes a task
+  SpinWaiter waiter(wait_strategy_);
+  auto finished = [this]() { return has_any_thread_just_finished_.load(); };
+  BaseSystem* system = nullptr;
+  while (system_manager_->GetNext(system)) {
+    if (system != nullptr) {
+      Dispatch(*system_manager_, *system);
+      continue;
+    }
+
+    if (!waiter.Poll(finished)) {
+      std::unique_lock<std::mutex> locker(wait_thread_lock_);
+      dispatcher_parked_.store(true);
+      wait_thread_condition_.wait(locker, finished);
+      dispatcher_parked_.store(false);
+    }
+    has_any_thread_just_finished_.store(false);
+  }
+
+  traversing_manager_ = nullptr;
+  traversing_func_ = nullptr;
+}
+
+void gs::MultiThreadTraverser::Dispatch(SystemManager& manager, BaseSystem& system) {
+  auto thread_family = system.initializer_family_;
+  if (thread_family >= pending_tasks_.size() || pending_tasks_[thread_family] == nullptr) {
+    std::lock_guard<std::mutex> locker(all_threads_lock_);
+    if (thread_family >= all_threads_.size()) {
+      all_threads_.resize(thread_family + 1);
+      all_threads_[thread_family].reserve(DEFAULT_custom_thread_COUNT);
+    }
+    if (pending_tasks_.size() < all_threads_.size()) {
+      pending_tasks_.resize(all_threads_.size());
+    }
+    if (pending_tasks_[thread_family] == nullptr) {
+      pending_tasks_[thread_family] = std::make_unique<PendingTasks>();
+    }
+  }
+  auto& target_thread_list = all_threads_[thread_family];
+  auto& pending = *pending_tasks_[thread_family];
+  auto task = &system_tasks_[system.GetFamily()];
+
+  std::lock_guard<std::mutex> pending_locker(pending.lock);
+  // the queued systems go first, no thread of the family is idle while any is left
+  if (pending.Empty()) {
+    for (auto& thread : target_thread_list) {
+      if (thread->PostTask(task)) {
         return;
       }
     }
 
-    if (current_system) {
-      auto thread_family = current_system->initializer_family_;
-      if (thread_family >= all_threads_.size()) {
-        all_threads_.resize(thread_family + 1);
-        all_threads_[thread_family].reserve(DEFAULT_custom_thread_COUNT);
+    // create new thread
+    if (target_thread_list.size() < target_thread_list.capacity()) {
+      std::shared_ptr<SystemThreadBase> system_thread = nullptr;
+      if (thread_family < manager.thread_creator_.size()) {
+        system_thread = manager.thread_creator_[thread_family]();
       }
-      auto& target_thread_list = all_threads_[thread_family];
-
-      gs::MultiThreadTraverser::Thread::Task task = [system=current_system->weak_from_this(), &func]() {
-        auto system_strong = system.lock();
-        if (system_strong) {
-          func(system_strong);
-        }
-      };
-
-      int search_index = 0;
-      bool task_posted = false;
-      // check if any thread is available
-      for (; search_index < target_thread_list.size(); search_index++) {
-        auto& thread = target_thread_list[search_index];
-        if (thread->PostTask(task)) {
-          task_posted = true;
-          break;
+      CpuSet cpus;
+      {
+        std::lock_guard<std::mutex> locker(all_threads_lock_);
+        if (thread_family < affinities_.size()) {
+          cpus = affinities_[thread_family].Resolve(static_cast<int>(target_thread_list.size()));
         }
       }
-      if (task_posted) {
-        current_system = nullptr;
-        continue;
-      }
-
-      // create new thread
-      if (search_index < target_thread_list.capacity()) {
-        std::shared_ptr<SystemThreadBase> system_thread = nullptr;
-        if (thread_family < system_manager_->thread_creator_.size()) {
-          system_thread = system_manager_->thread_creator_[thread_family]();
-        }
-        auto thread = std::make_shared<Thread>(system_thread, this);
+      auto thread = std::make_shared<Thread>(system_thread, this, &pending, cpus);
+      {
+        std::lock_guard<std::mutex> locker(all_threads_lock_);
         target_thread_list.push_back(thread);
-        thread->StartLoop();
-        if (thread->PostTask(task)) {
-          current_system = nullptr;
-          continue;
-        }
       }
-
-      // failed, try again later
-      std::shared_ptr<BaseSystem> next;
-      system_manager_->GetNext(next);
-      if (next) {
-        system_manager_->OnSystemTryAgainLater(current_system->GetFamily());
-        current_system = next;
-        continue;
+      thread->StartLoop();
+      if (thread->PostTask(task)) {
+        return;
       }
     }
+  }
+  pending.Push(manager.rank_of_index_[manager.schedule_.IndexOf(system.GetFamily())], task);
+}
 
-    // wait until any system is done
-    {
-      std::unique_lock<std::mutex> locker(wait_thread_lock_);
-      if (!has_any_thread_just_finished_) {
-        wait_thread_condition_.wait(locker);
-      }
-      has_any_thread_just_finished_ = false;
-    }
+void gs::MultiThreadTraverser::PendingTasks::Push(int rank, Task* task) {
+  tasks.emplace_back(rank, task);
+  std::push_heap(tasks.begin(), tasks.end(), std::greater<std::pair<int, Task*>>());
+}
+
+gs::MultiThreadTraverser::Task* gs::MultiThreadTraverser::PendingTasks::Pop() {
+  if (Empty()) {
+    return nullptr;
   }
+  std::pop_heap(tasks.begin(), tasks.end(), std::greater<std::pair<int, Task*>>());
+  auto task = tasks.back().second;
+  tasks.pop_back();
+  return task;
+}
+
+void gs::MultiThreadTraverser::Run(gs::BaseSystem::Family family) {
+  (*traversing_func_)(traversing_manager_->all_systems_[family]);
 }
 
 void gs::MultiThreadTraverser::SetMaxThreadCount(gs::SystemThreadBase::Family family, int count) {
+  std::lock_guard<std::mutex> locker(all_threads_lock_);
   if (family >= all_threads_.size()) {
     all_threads_.resize(family + 1);
   }
   all_threads_[family].reserve(count);
 }
 
+void gs::MultiThreadTraverser::SetThreadAffinity(gs::SystemThreadBase::Family family,
+                                                 const gs::ThreadAffinity& affinity) {
+  std::lock_guard<std::mutex> locker(all_threads_lock_);
+  if (family >= affinities_.size()) {
+    affinities_.resize(family + 1);
+  }
+  affinities_[family] = affinity;
+}
+
+void gs::MultiThreadTraverser::ParallelFor(int count, const std::function<void(int)>& job) {
+  // helpers may outlive this call, they only hold the state and never touch `job` once all jobs are claimed
+  auto state = std::make_shared<ParallelForState>(count, job);
+  {
+    std::lock_guard<std::mutex> locker(all_threads_lock_);
+    auto family = DefaultThread::family();
+    if (family < all_threads_.size()) {
+      int helper_count = 0;
+      ParallelForTask* helper = nullptr;
+      for (auto& thread : all_threads_[family]) {
+        if (helper_count + 1 >= count) {
+          break;
+        }
+        if (helper == nullptr) {
+          helper = new ParallelForTask(state);
+        }
+        if (thread->PostTask(helper)) {
+          helper = nullptr;
+          helper_count++;
+        }
+      }
+      delete helper;
+    }
+  }
+  state->Work();
+  state->Wait();
+}
+
+void gs::MultiThreadTraverser::ParallelForTask::Run() {
+  state->Work();
+  // helpers are allocated by `ParallelFor` and owned by the thread which runs them
+  delete this;
+}
+
 void gs::MultiThreadTraverser::Thread::StartLoop() {
   need_stop_ = false;
   thread_ = std::make_shared<std::thread>([this]() {
+    if (cpus_.any()) {
+      Affinity::PinCurrentThread(cpus_);
+    }
     if (system_thread_) {
       system_thread_->OnInit();
     }
 
-    while (!need_stop_) {
-      bool has_task = false;
-      {
-        std::unique_lock<std::mutex> locker(task_lock_);
-        has_task = current_task_ != nullptr;
-      }
-
-      if (!has_task) {
-        std::unique_lock<std::mutex> condition_locker(condition_lock_);
-        if (need_stop_) {
-          break;
-        }
-        if (current_task_ == nullptr) {
-          condition_.wait(condition_locker);
-          continue;
+    SpinWaiter waiter(traverser_->wait_strategy_);
+    auto has_task = [this]() { return current_task_.load() != nullptr || need_stop_.load(); };
+    while (!need_stop_.load()) {
+      if (current_task_.load() == nullptr) {
+        if (!waiter.Poll(has_task)) {
+          std::unique_lock<std::mutex> condition_locker(condition_lock_);
+          parked_.store(true);
+          condition_.wait(condition_locker, has_task);
+          parked_.store(false);
         }
+        continue;
       }
 
-      current_task_();
+      current_task_.load()->Run();
 
-      {
-        std::unique_lock<std::mutex> locker(task_lock_);
-        current_task_ = nullptr;
+      traverser_->has_any_thread_just_finished_.store(true);
+      if (traverser_->dispatcher_parked_.load()) {
+        std::lock_guard<std::mutex> locker(traverser_->wait_thread_lock_);
+        traverser_->wait_thread_condition_.notify_all();
       }
 
+      // take the next queued system of this family right away, or go idle
       {
-        std::lock_guard<std::mutex> locker(traverser_->wait_thread_lock_);
-        traverser_->has_any_thread_just_finished_ = true;
-        traverser_->wait_thread_condition_.notify_all();
+        std::lock_guard<std::mutex> pending_locker(pending_->lock);
+        std::unique_lock<std::mutex> locker(task_lock_);
+        current_task_.store(pending_->Pop());
       }
     }
 
@@ -161,18 +242,20 @@ void gs::MultiThreadTraverser::Thread::StartLoop() {
   });
 }
 
-bool gs::MultiThreadTraverser::Thread::PostTask(const Task& task) {
-  std::unique_lock<std::mutex> locker(task_lock_);
-  if (current_task_ == nullptr) {
-    current_task_ = task;
-    {
-      std::lock_guard<std::mutex> condition_locker(condition_lock_);
-      condition_.notify_all();
+bool gs::MultiThreadTraverser::Thread::PostTask(Task* task) {
+  {
+    std::unique_lock<std::mutex> locker(task_lock_);
+    if (current_task_.load() != nullptr) {
+      return false;
     }
-    return true;
-  } else{
-    return false;
+    current_task_.store(task);
+  }
+  // a spinning thread picks it up by itself
+  if (parked_.load()) {
+    std::lock_guard<std::mutex> condition_locker(condition_lock_);
+    condition_.notify_all();
   }
+  return true;
 }
 
 void gs::MultiThreadTraverser::Thread::StopLoop() {
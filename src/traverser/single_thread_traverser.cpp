@@ -48,14 +48,14 @@ void gs::SingleThreadTraverser::Traverse(std::function<void(std::shared_ptr<gs::
   }
 
   while (true) {
-    std::shared_ptr<BaseSystem> next;
+    BaseSystem* next;
     auto success = system_manager_->GetNext(next);
     if (!success) {
       return;
     }
     if (next) {
       CheckThread(next->initializer_family_);
-      func(next);
+      func(system_manager_->all_systems_[next->GetFamily()]);
     }
   }
 }
\ No newline at end of file
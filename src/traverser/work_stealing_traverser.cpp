@@ -0,0 +1,321 @@
+/*
+ * Copyright (c) 2026 by GallenShao, All Rights Reserved.
+ *
+ * work_stealing_traverser.cpp
+ *
+ *  Created on: 2026.10.17
+ *  Author: gallenshao
+ */
+
+#include "lock_free_queue.hpp"
+#include "system.h"
+#include "wait_strategy.hpp"
+#include <algorithm>
+
+#define DEFAULT_default_thread_COUNT 4
+#define DEFAULT_custom_thread_COUNT 1
+#define MIN_WORKER_QUEUE_SIZE 256
+
+thread_local gs::WorkStealingTraverser::Worker* gs::WorkStealingTraverser::current_worker_ = nullptr;
+
+gs::WorkStealingTraverser::WorkStealingTraverser(const WaitStrategy& wait_strategy) : wait_strategy_(wait_strategy) {
+  WorkStealingTraverser::SetMaxThreadCount(DefaultThread::family(), DEFAULT_default_thread_COUNT);
+}
+
+gs::WorkStealingTraverser::~WorkStealingTraverser() {
+  for (auto& group : groups_) {
+    if (group) {
+      for (auto& worker : group->workers) {
+        worker->StopLoop();
+      }
+      group->workers.clear();
+    }
+  }
+  groups_.clear();
+}
+
+void gs::WorkStealingTraverser::Traverse(std::function<void(std::shared_ptr<gs::BaseSystem>&)> func) {
+  auto system_manager_ = manager_.lock();
+  if (system_manager_ == nullptr) {
+    return;
+  }
+
+  traversing_manager_ = system_manager_.get();
+  traversing_func_ = &func;
+
+  auto system_count = system_manager_->all_systems_.size();
+  if (system_jobs_.size() != system_count) {
+    system_jobs_.resize(system_count);
+    for (int family = 0; family < system_count; family++) {
+      system_jobs_[family].traverser = this;
+      system_jobs_[family].family = family;
+    }
+  }
+
+  SpinWaiter waiter(wait_strategy_);
+  while (true) {
+    auto epoch = finished_epoch_.load();
+
+    BaseSystem* next;
+    bool success;
+    while ((success = system_manager_->GetNext(next)) && next) {
+      Dispatch(*system_manager_, *next);
+    }
+    if (!success && pending_.load() == 0) {
+      break;
+    }
+
+    // wait until any system is done
+    auto finished = [this, epoch]() { return finished_epoch_.load() != epoch; };
+    if (waiter.Poll(finished)) {
+      continue;
+    }
+    dispatcher_sleeping_.store(true);
+    {
+      std::unique_lock<std::mutex> locker(dispatcher_lock_);
+      dispatcher_condition_.wait(locker, finished);
+    }
+    dispatcher_sleeping_.store(false);
+  }
+
+  traversing_manager_ = nullptr;
+  traversing_func_ = nullptr;
+}
+
+void gs::WorkStealingTraverser::SetMaxThreadCount(gs::SystemThreadBase::Family family, int count) {
+  GetGroup(family).max_count = count;
+}
+
+void gs::WorkStealingTraverser::SetThreadAffinity(gs::SystemThreadBase::Family family,
+                                                  const gs::ThreadAffinity& affinity) {
+  GetGroup(family).affinity = affinity;
+}
+
+gs::WorkStealingTraverser::WorkerGroup& gs::WorkStealingTraverser::GetGroup(gs::SystemThreadBase::Family family) {
+  if (family >= groups_.size()) {
+    groups_.resize(family + 1);
+  }
+  auto& group = groups_[family];
+  if (group == nullptr) {
+    group = std::make_unique<WorkerGroup>();
+    group->max_count = DEFAULT_custom_thread_COUNT;
+  }
+  return *group;
+}
+
+void gs::WorkStealingTraverser::Dispatch(gs::SystemManager& manager, gs::BaseSystem& system) {
+  auto thread_family = system.initializer_family_;
+  auto& group = GetGroup(thread_family);
+
+  // create all workers of this family at once, so that the group never changes while they are stealing
+  if (group.workers.empty()) {
+    auto count = group.max_count > 0 ? group.max_count : 1;
+    auto capacity = std::max<size_t>(manager.all_systems_.size(), MIN_WORKER_QUEUE_SIZE);
+    for (int index = 0; index < count; index++) {
+      std::shared_ptr<SystemThreadBase> system_thread = nullptr;
+      if (thread_family < manager.thread_creator_.size() && manager.thread_creator_[thread_family]) {
+        system_thread = manager.thread_creator_[thread_family]();
+      }
+      group.workers.push_back(std::make_unique<Worker>(system_thread, &group, index, capacity, this));
+    }
+    for (auto& worker : group.workers) {
+      worker->StartLoop();
+    }
+  }
+
+  // prefer a sleeping worker, otherwise round-robin
+  int count = static_cast<int>(group.workers.size());
+  int target = group.next;
+  for (int i = 0; i < count; i++) {
+    auto index = (group.next + i) % count;
+    if (group.workers[index]->IsSleeping()) {
+      target = index;
+      break;
+    }
+  }
+  group.next = (target + 1) % count;
+
+  pending_.fetch_add(1);
+  group.workers[target]->Post(&system_jobs_[system.GetFamily()]);
+}
+
+void gs::WorkStealingTraverser::Run(gs::BaseSystem::Family family) {
+  (*traversing_func_)(traversing_manager_->all_systems_[family]);
+
+  pending_.fetch_sub(1);
+  finished_epoch_.fetch_add(1);
+  if (dispatcher_sleeping_.load()) {
+    std::lock_guard<std::mutex> locker(dispatcher_lock_);
+    dispatcher_condition_.notify_one();
+  }
+}
+
+void gs::WorkStealingTraverser::ParallelFor(int count, const std::function<void(int)>& job) {
+  auto worker = current_worker_;
+  if (worker == nullptr || worker->traverser_ != this) {
+    SystemTraverser::ParallelFor(count, job);
+    return;
+  }
+
+  // helpers may outlive this call, they only hold the state and never touch `job` once all jobs are claimed
+  auto state = std::make_shared<ParallelForState>(count, job);
+  auto helper_count = std::min(count, static_cast<int>(worker->group_->workers.size())) - 1;
+  for (int i = 0; i < helper_count; i++) {
+    auto helper = new ParallelForJob(state);
+    if (!worker->Push(helper)) {
+      delete helper;
+      break;
+    }
+  }
+  for (auto& sibling : worker->group_->workers) {
+    if (helper_count <= 0) {
+      break;
+    }
+    if (sibling.get() != worker && sibling->IsSleeping()) {
+      sibling->Wake();
+      helper_count--;
+    }
+  }
+
+  state->Work();
+  state->Wait();
+}
+
+void gs::WorkStealingTraverser::ParallelForJob::Run() {
+  state->Work();
+  // helpers are allocated by `ParallelFor` and owned by whoever runs them
+  delete this;
+}
+
+gs::WorkStealingTraverser::Worker::Worker(std::shared_ptr<SystemThreadBase>& system_thread, WorkerGroup* group,
+                                          int index, size_t capacity, WorkStealingTraverser* traverser)
+    : system_thread_(system_thread),
+      deque_(capacity),
+      inbox_(capacity),
+      group_(group),
+      index_(index),
+      traverser_(traverser) {}
+
+void gs::WorkStealingTraverser::Worker::StartLoop() {
+  need_stop_ = false;
+  auto cpus = group_->affinity.Resolve(index_);
+  thread_ = std::make_shared<std::thread>([this, cpus]() {
+    current_worker_ = this;
+    if (cpus.any()) {
+      Affinity::PinCurrentThread(cpus);
+    }
+    if (system_thread_) {
+      system_thread_->OnInit();
+    }
+
+    SpinWaiter waiter(traverser_->wait_strategy_);
+    auto has_work = [this]() { return need_stop_.load() || HasWork(); };
+    while (true) {
+      Job* job;
+      if (Acquire(job)) {
+        job->Run();
+        continue;
+      }
+
+      // a spinning worker is not `sleeping_`, so nobody has to notify it
+      if (waiter.Poll(has_work)) {
+        if (need_stop_.load() && !HasWork()) {
+          break;
+        }
+        continue;
+      }
+
+      sleeping_.store(true);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      {
+        std::unique_lock<std::mutex> condition_locker(condition_lock_);
+        condition_.wait(condition_locker, has_work);
+      }
+      sleeping_.store(false);
+
+      if (need_stop_.load() && !HasWork()) {
+        break;
+      }
+    }
+
+    if (system_thread_) {
+      system_thread_->OnDestroy();
+    }
+  });
+}
+
+void gs::WorkStealingTraverser::Worker::Post(Job* job) {
+  auto success = inbox_.Push(job);
+  assert(success);
+  Wake();
+}
+
+bool gs::WorkStealingTraverser::Worker::Push(Job* job) {
+  return deque_.Push(job);
+}
+
+void gs::WorkStealingTraverser::Worker::Wake() {
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (sleeping_.load()) {
+    std::lock_guard<std::mutex> condition_locker(condition_lock_);
+    condition_.notify_one();
+  }
+}
+
+void gs::WorkStealingTraverser::Worker::StopLoop() {
+  need_stop_ = true;
+  {
+    std::lock_guard<std::mutex> condition_locker(condition_lock_);
+    condition_.notify_all();
+  }
+  if (thread_ && thread_->joinable()) {
+    thread_->join();
+    thread_ = nullptr;
+  }
+}
+
+bool gs::WorkStealingTraverser::Worker::HasWork() const {
+  for (auto& worker : group_->workers) {
+    if (!worker->deque_.Empty() || !worker->inbox_.Empty()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool gs::WorkStealingTraverser::Worker::Acquire(Job*& job) {
+  if (deque_.Pop(job)) {
+    return true;
+  }
+
+  if (inbox_.Pop(job)) {
+    // move the rest of the inbox to the deque, so that idle siblings can steal them
+    bool shared = false;
+    Job* extra;
+    while (inbox_.Pop(extra)) {
+      if (!deque_.Push(extra)) {
+        inbox_.Push(extra);
+        break;
+      }
+      shared = true;
+    }
+    if (shared) {
+      for (auto& worker : group_->workers) {
+        if (worker.get() != this && worker->IsSleeping()) {
+          worker->Wake();
+          break;
+        }
+      }
+    }
+    return true;
+  }
+
+  auto count = group_->workers.size();
+  for (size_t i = 1; i < count; i++) {
+    auto& sibling = group_->workers[(index_ + i) % count];
+    if (sibling->deque_.Steal(job) || sibling->inbox_.Pop(job)) {
+      return true;
+    }
+  }
+  return false;
+}
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2026 by GallenShao, All Rights Reserved.
+ *
+ * affinity_test.cpp
+ *
+ *  Created on: 2026.10.17
+ *  Author: gallenshao
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include "gs_ecs.h"
+#include "gs_ecs_test_header.h"
+
+TEST(AffinityTest, Resolve) {
+  EXPECT_TRUE(gs::ThreadAffinity().Empty());
+  EXPECT_TRUE(gs::ThreadAffinity().Resolve(0).none());
+
+  auto affinity = gs::ThreadAffinity::Cpus({1, 3, 5});
+  EXPECT_EQ(affinity.Resolve(2).count(), 3);
+  affinity.one_cpu_per_thread = true;
+  EXPECT_TRUE(affinity.Resolve(0).test(1));
+  EXPECT_TRUE(affinity.Resolve(1).test(3));
+  EXPECT_TRUE(affinity.Resolve(4).test(3));
+  EXPECT_EQ(affinity.Resolve(4).count(), 1);
+
+  // every machine has a node, whose id is not always 0
+  auto nodes = gs::Affinity::Nodes();
+  ASSERT_GE(nodes.size(), 1);
+  EXPECT_EQ(nodes.size(), gs::Affinity::NodeCount());
+  EXPECT_TRUE(std::is_sorted(nodes.begin(), nodes.end()));
+  EXPECT_TRUE(gs::ThreadAffinity::Node(nodes.front()).Resolve(0).any());
+}
+
+std::mutex pinned_lock;
+std::vector<gs::CpuSet> pinned_cpus;
+
+class PinnedSystem : public gs::System<PinnedSystem> {
+ public:
+  void Update(gs::EntityManager& manager) override {
+    std::lock_guard<std::mutex> locker(pinned_lock);
+    pinned_cpus.push_back(gs::Affinity::CurrentThreadCpus());
+  }
+};
+
+template <typename T>
+void TestPinning(const gs::CpuSet& cpus) {
+  pinned_cpus.clear();
+  auto manager = gs::SystemManager::MakeFromTraverser<T>();
+  manager->template AddSystem<PinnedSystem>();
+  gs::ThreadAffinity affinity;
+  affinity.cpus = cpus;
+  manager->SetThreadAffinity(affinity);
+
+  gs::EntityManager dummy;
+  for (int i = 0; i < 10; i++) {
+    manager->Update(dummy);
+  }
+  ASSERT_EQ(pinned_cpus.size(), 10);
+  for (auto& pinned : pinned_cpus) {
+    EXPECT_EQ(pinned, cpus);
+  }
+}
+
+TEST(AffinityTest, Pinning) {
+  // a single CPU this process is allowed to run on
+  auto allowed = gs::Affinity::CurrentThreadCpus();
+  gs::CpuSet cpus;
+  for (int cpu = MAX_CPU_COUNT - 1; cpu >= 0; cpu--) {
+    if (allowed.test(cpu)) {
+      cpus.set(cpu);
+      break;
+    }
+  }
+  ASSERT_TRUE(cpus.any());
+
+  TestPinning<gs::MultiThreadTraverser>(cpus);
+  TestPinning<gs::WorkStealingTraverser>(cpus);
+}
+
+TEST(AffinityTest, NodeLocalChunkAllocator) {
+  auto allocator = std::make_shared<gs::NodeLocalChunkAllocator>();
+  EXPECT_EQ(allocator->node_count(), gs::Affinity::NodeCount());
+
+  auto chunk = allocator->Allocate(CHUNK_SIZE);
+  ASSERT_NE(chunk, nullptr);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(chunk) % CHUNK_ALIGNMENT, 0);
+  // taken from an online node, by its id
+  auto nodes = gs::Affinity::Nodes();
+  EXPECT_NE(std::find(nodes.begin(), nodes.end(), allocator->NodeOf(chunk)), nodes.end());
+  EXPECT_EQ(allocator->NodeOf(&allocator), -1);
+  auto large = allocator->Allocate(NODE_SLAB_SIZE);
+  EXPECT_GE(allocator->NodeOf(static_cast<uint8_t*>(large) + NODE_SLAB_SIZE - 1), 0);
+
+  // released blocks are reused
+  allocator->Deallocate(chunk, CHUNK_SIZE);
+  EXPECT_EQ(allocator->Allocate(CHUNK_SIZE), chunk);
+  allocator->Deallocate(chunk, CHUNK_SIZE);
+  allocator->Deallocate(large, NODE_SLAB_SIZE);
+
+  gs::EntityManager manager(allocator);
+  std::vector<gs::Entity> entities;
+  for (int i = 0; i < 10000; i++) {
+    auto entity = manager.Create();
+    manager.Assign<Position>(entity, static_cast<float>(i), 0.f);
+    entities.push_back(entity);
+  }
+  for (int i = 0; i < 10000; i += 2) {
+    manager.Destroy(entities[i]);
+  }
+  EXPECT_EQ(manager.View<const Position>().Size(), 5000);
+  EXPECT_EQ(manager.Get<Position>(entities[9999])->x, 9999);
+}
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2026 by GallenShao, All Rights Reserved.
+ *
+ * allocator_test.cpp
+ *
+ *  Created on: 2026.10.17
+ *  Author: gallenshao
+ */
+
+#include <gtest/gtest.h>
+
+#include "gs_ecs.h"
+#include "gs_ecs_test_header.h"
+
+class CountingAllocator : public gs::HeapChunkAllocator {
+ public:
+  void* Allocate(size_t size) override {
+    allocated++;
+    return HeapChunkAllocator::Allocate(size);
+  }
+  void Deallocate(void* ptr, size_t size) override {
+    deallocated++;
+    HeapChunkAllocator::Deallocate(ptr, size);
+  }
+  int allocated = 0;
+  int deallocated = 0;
+};
+
+// chunks released by an archetype are cached and reused instead of going back to the heap
+TEST(AllocatorTest, ChunkPool) {
+  auto pool = std::make_shared<gs::ChunkPool>();
+  gs::EntityManager manager(pool);
+  EXPECT_EQ(manager.allocator(), pool);
+
+  std::vector<gs::Entity> entities;
+  for (int i = 0; i < 10000; i++) {
+    auto entity = manager.Create();
+    manager.Assign<Position>(entity);
+    entities.push_back(entity);
+  }
+  // the chunks of the empty archetype were released while the entities moved out
+  auto cached = pool->cached_bytes();
+
+  for (auto& entity : entities) {
+    manager.Remove<Position>(entity);
+  }
+  EXPECT_GE(pool->cached_bytes(), cached + CHUNK_SIZE);
+  cached = pool->cached_bytes();
+
+  for (auto& entity : entities) {
+    manager.Assign<Velocity>(entity);
+  }
+  EXPECT_LT(pool->cached_bytes(), cached);
+
+  pool->Trim();
+  EXPECT_EQ(pool->cached_bytes(), 0);
+
+  // the chunks released after a peak are only cached up to a bound
+  for (int i = 0; i < 400000; i++) {
+    manager.Assign<Position>(manager.Create());
+  }
+  manager.View<const Position>().ForEach(
+      [&entities](gs::Entity entity, const Position&) { entities.push_back(entity); });
+  for (auto& entity : entities) {
+    manager.Destroy(entity);
+  }
+  EXPECT_GT(pool->cached_bytes(), 0);
+  EXPECT_LE(pool->cached_bytes(), DEFAULT_POOL_CACHE_SIZE);
+}
+
+TEST(AllocatorTest, LinearArena) {
+  auto allocator = std::make_shared<CountingAllocator>();
+  {
+    gs::LinearArena arena(allocator, 1024);
+    auto first = arena.Allocate(10, 1);
+    auto aligned = arena.Allocate(8, 64);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(aligned) % 64, 0);
+    EXPECT_NE(first, aligned);
+    // larger than a block
+    auto large = arena.Allocate(4096, 16);
+    EXPECT_NE(large, nullptr);
+    EXPECT_EQ(arena.used(), 10 + 8 + 4096);
+    EXPECT_EQ(allocator->allocated, 2);
+
+    // blocks are reused after a reset
+    arena.Reset();
+    EXPECT_EQ(arena.used(), 0);
+    EXPECT_EQ(arena.Allocate(10, 1), first);
+    for (int i = 0; i < 100; i++) {
+      arena.Allocate(16, 16);
+    }
+    EXPECT_EQ(allocator->allocated, 2);
+  }
+  EXPECT_EQ(allocator->deallocated, 2);
+}
+
+class ScratchSystem : public gs::System<ScratchSystem> {
+ public:
+  void Update(gs::EntityManager& manager) override {
+    auto values = static_cast<int*>(FrameArena().Allocate(sizeof(int) * 1000, alignof(int)));
+    for (int i = 0; i < 1000; i++) {
+      values[i] = i;
+    }
+    if (last != nullptr) {
+      reused = reused && last == values;
+    }
+    last = values;
+  }
+  int* last = nullptr;
+  bool reused = true;
+};
+
+// the frame arena is reset at the start of every Update, so the same memory is handed out each frame
+TEST(AllocatorTest, FrameArena) {
+  auto allocator = std::make_shared<CountingAllocator>();
+  auto manager = gs::SystemManager::MakeFromTraverser<gs::SingleThreadTraverser>();
+  manager->SetAllocator(allocator);
+  manager->AddSystem<ScratchSystem>();
+
+  gs::EntityManager entities;
+  for (int i = 0; i < 100; i++) {
+    manager->Update(entities);
+  }
+  EXPECT_TRUE(manager->Get<ScratchSystem>()->reused);
+  EXPECT_EQ(allocator->allocated, 1);
+}
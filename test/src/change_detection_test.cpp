@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2026 by GallenShao, All Rights Reserved.
+ *
+ * change_detection_test.cpp
+ *
+ *  Created on: 2026.10.17
+ *  Author: gallenshao
+ */
+
+#include <gtest/gtest.h>
+
+#include "gs_ecs.h"
+#include "gs_ecs_test_header.h"
+
+TEST(ChangeDetectionTest, ChangedSince) {
+  gs::EntityManager manager;
+  std::vector<gs::Entity> entities;
+  for (int i = 0; i < 10000; i++) {
+    auto entity = manager.Create();
+    manager.Assign<Position>(entity, static_cast<float>(i), 0.f);
+    manager.Assign<Velocity>(entity);
+    entities.push_back(entity);
+  }
+  auto chunks = manager.View<const Position>().ChunkCount();
+  ASSERT_GT(chunks, 1);
+
+  // everything is newer than 0
+  EXPECT_EQ(manager.View<const Position>().ChangedSince<Position>(0).Size(), 10000);
+
+  auto since = manager.tick();
+  manager.SetTick(since + 1);
+  EXPECT_EQ(manager.View<const Position>().ChangedSince<Position>(since).Size(), 0);
+
+  // writing through Get marks the chunk
+  manager.Get<Position>(entities[42])->x = -1;
+  auto changed = manager.View<const Position>().ChangedSince<Position>(since);
+  EXPECT_EQ(changed.ChunkCount(), 1);
+  int count = 0;
+  bool found = false;
+  changed.ForEach([&count, &found](const Position& position) {
+    found |= position.x == -1;
+    count++;
+  });
+  EXPECT_TRUE(found);
+  EXPECT_LT(count, 10000);
+  EXPECT_EQ(manager.View<const Velocity>().ChangedSince<Velocity>(since).Size(), 0);
+
+  // const columns are not marked, non-const ones are
+  manager.SetTick(since + 2);
+  manager.View<const Position, Velocity>().ForEach([](const Position&, Velocity& velocity) { velocity.x = 1; });
+  EXPECT_EQ(manager.View<const Position>().ChangedSince<Position>(since + 1).Size(), 0);
+  EXPECT_EQ(manager.View<const Position>().ChangedSince<Velocity>(since + 1).Size(), 10000);
+  EXPECT_EQ((manager.View<const Position>().ChangedSince<Position, Velocity>(since + 1).ChunkCount()), chunks);
+}
+
+// counts the positions changed since its previous run
+class ReadPositionSystem : public gs::System<ReadPositionSystem> {
+ public:
+  typedef gs::ComponentList<const Position> Access;
+  void Update(gs::EntityManager& manager) override {
+    count = manager.View<const Position>().ChangedSince<Position>(LastRunTick()).Size();
+  }
+  size_t count = 0;
+};
+
+// registered after the reader, so it runs after it within a frame
+class WritePositionSystem : public gs::System<WritePositionSystem> {
+ public:
+  typedef gs::ComponentList<Position> Access;
+  void Update(gs::EntityManager& manager) override {
+    if (target != gs::Entity()) {
+      manager.Get<Position>(target)->x++;
+      target = gs::Entity();
+    }
+  }
+  gs::Entity target;
+};
+
+// writes the velocities it has seen changing, its own writes are not reported back to it
+class DampVelocitySystem : public gs::System<DampVelocitySystem> {
+ public:
+  typedef gs::ComponentList<Velocity> Access;
+  void Update(gs::EntityManager& manager) override {
+    count = 0;
+    ParallelForEach(manager.View<Velocity>().ChangedSince<Velocity>(LastRunTick()), [this](Velocity& velocity) {
+      velocity.x *= 0.5f;
+      count++;
+    });
+  }
+  std::atomic<int> count = {0};
+};
+
+template <typename T>
+void TestChangeDetection() {
+  auto manager = gs::SystemManager::MakeFromTraverser<T>();
+  manager->template AddSystem<ReadPositionSystem>();
+  manager->template AddSystem<WritePositionSystem>();
+  manager->template AddSystem<DampVelocitySystem>();
+  auto reader = manager->template Get<ReadPositionSystem>();
+  auto writer = manager->template Get<WritePositionSystem>();
+  auto damper = manager->template Get<DampVelocitySystem>();
+
+  gs::EntityManager entities;
+  std::vector<gs::Entity> items;
+  for (int i = 0; i < 10000; i++) {
+    auto entity = entities.Create();
+    entities.Assign<Position>(entity);
+    entities.Assign<Velocity>(entity, 1.f, 0.f);
+    items.push_back(entity);
+  }
+
+  manager->Update(entities);
+  EXPECT_EQ(reader->count, 10000);
+  EXPECT_EQ(damper->count, 10000);
+
+  // static entities are skipped
+  manager->Update(entities);
+  EXPECT_EQ(reader->count, 0);
+  EXPECT_EQ(damper->count, 0);
+
+  // the write happens after the reader ran, it is seen the next frame
+  writer->target = items[42];
+  manager->Update(entities);
+  EXPECT_EQ(reader->count, 0);
+  manager->Update(entities);
+  EXPECT_GT(reader->count, 0);
+  EXPECT_LT(reader->count, 10000);
+  manager->Update(entities);
+  EXPECT_EQ(reader->count, 0);
+
+  // writes between frames are seen by every system
+  entities.Get<Velocity>(items[0])->x = 1;
+  manager->Update(entities);
+  EXPECT_GT(damper->count, 0);
+  EXPECT_LT(damper->count, 10000);
+  manager->Update(entities);
+  EXPECT_EQ(damper->count, 0);
+}
+
+TEST(ChangeDetectionTest, Systems) {
+  TestChangeDetection<gs::SingleThreadTraverser>();
+  TestChangeDetection<gs::MultiThreadTraverser>();
+  TestChangeDetection<gs::WorkStealingTraverser>();
+}
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2026 by GallenShao, All Rights Reserved.
+ *
+ * command_buffer_test.cpp
+ *
+ *  Created on: 2026.10.17
+ *  Author: gallenshao
+ */
+
+#include <gtest/gtest.h>
+
+#include "gs_ecs.h"
+#include "gs_ecs_test_header.h"
+
+TEST(CommandBufferTest, Playback) {
+  gs::EntityManager manager;
+  auto existing = manager.Create();
+  manager.Assign<Position>(existing, 1.f, 1.f);
+  auto destroyed = manager.Create();
+
+  gs::CommandBuffer commands;
+  auto created = commands.Create();
+  commands.Assign<Name>(created, "spawned");
+  commands.Assign<Position>(created, 2.f, 3.f);
+  commands.Assign<Position>(existing, 4.f, 5.f);
+  commands.Assign<Velocity>(existing, 1.f, 0.f);
+  commands.Remove<Position>(existing);
+  commands.Destroy(destroyed);
+  // the entity is already gone when this one runs
+  commands.Assign<Name>(destroyed, "skipped");
+  EXPECT_FALSE(commands.Empty());
+  EXPECT_EQ(manager.Size(), 2);
+
+  commands.Playback(manager);
+  EXPECT_TRUE(commands.Empty());
+  EXPECT_EQ(manager.Size(), 2);
+  EXPECT_FALSE(manager.Valid(destroyed));
+  EXPECT_FALSE(manager.Has<Position>(existing));
+  EXPECT_EQ(manager.Get<Velocity>(existing)->x, 1.f);
+
+  int count = 0;
+  manager.View<const Name, const Position>().ForEach([&count](const Name& name, const Position& position) {
+    EXPECT_EQ(name.value, "spawned");
+    EXPECT_EQ(position.x, 2.f);
+    EXPECT_EQ(position.y, 3.f);
+    count++;
+  });
+  EXPECT_EQ(count, 1);
+
+  // cleared commands are dropped, the buffer is reused
+  commands.Assign<Name>(commands.Create(), "dropped");
+  commands.Clear();
+  commands.Playback(manager);
+  EXPECT_EQ(manager.Size(), 2);
+}
+
+struct Spawned : public gs::Component<Spawned> {
+  Spawned() = default;
+  explicit Spawned(int frame) : frame(frame) {}
+  int frame = 0;
+};
+
+template <int N>
+class SpawnSystem : public gs::System<SpawnSystem<N>> {
+ public:
+  static constexpr bool SyncPoint = true;
+  void Update(gs::EntityManager& manager) override {
+    for (int i = 0; i < N; i++) {
+      auto entity = this->Commands().Create();
+      this->Commands().template Assign<Spawned>(entity, frame);
+    }
+    frame++;
+  }
+  int frame = 0;
+};
+
+// runs in the same dependency level as the spawners, but without a sync point of its own
+class DespawnSystem : public gs::System<DespawnSystem> {
+ public:
+  void Update(gs::EntityManager& manager) override {
+    std::vector<gs::Entity> entities;
+    manager.View<const Spawned>().ForEachChunk([&entities](int size, const gs::Entity* chunk, const Spawned*) {
+      entities.insert(entities.end(), chunk, chunk + size);
+    });
+    for (auto& entity : entities) {
+      Commands().Destroy(entity);
+    }
+  }
+};
+
+class CountSpawnedSystem : public gs::System<CountSpawnedSystem> {
+ public:
+  typedef gs::ComponentList<const Spawned> Access;
+  void Update(gs::EntityManager& manager) override {
+    count = 0;
+    manager.View<const Spawned>().ForEach([this](const Spawned&) { count++; });
+  }
+  int count = 0;
+};
+
+template <typename T>
+void TestSyncPoint() {
+  auto manager = gs::SystemManager::MakeFromTraverser<T>();
+  manager->template AddSystem<SpawnSystem<10>>();
+  manager->template AddSystem<SpawnSystem<20>>();
+  manager->template AddSystem<DespawnSystem>();
+  manager->template AddSystem<CountSpawnedSystem>()
+      .template WhichDependsOn<SpawnSystem<10>>()
+      .template And<SpawnSystem<20>>()
+      .template And<DespawnSystem>();
+
+  gs::EntityManager entities;
+  for (int frame = 0; frame < 10; frame++) {
+    manager->Update(entities);
+    // the previous frame's entities are destroyed at the same sync point as the new ones are spawned
+    EXPECT_EQ(manager->template Get<CountSpawnedSystem>()->count, 30);
+    EXPECT_EQ(entities.Size(), 30);
+  }
+}
+
+TEST(CommandBufferTest, SyncPoint) {
+  TestSyncPoint<gs::SingleThreadTraverser>();
+  TestSyncPoint<gs::MultiThreadTraverser>();
+  TestSyncPoint<gs::WorkStealingTraverser>();
+}
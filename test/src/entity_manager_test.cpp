@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) 2026 by GallenShao, All Rights Reserved.
+ *
+ * entity_manager_test.cpp
+ *
+ *  Created on: 2026.10.17
+ *  Author: gallenshao
+ */
+
+#include <gtest/gtest.h>
+
+#include "gs_ecs.h"
+#include "gs_ecs_test_header.h"
+
+TEST(EntityManagerTest, AssignAndGet) {
+  gs::EntityManager manager;
+  auto entity = manager.Create();
+  EXPECT_TRUE(manager.Valid(entity));
+  EXPECT_FALSE(manager.Has<Position>(entity));
+  EXPECT_EQ(manager.Get<Position>(entity), nullptr);
+
+  manager.Assign<Position>(entity, 1.f, 2.f);
+  manager.Assign<Name>(entity, "player");
+  EXPECT_TRUE(manager.Has<Position>(entity));
+  EXPECT_FALSE(manager.Has<Velocity>(entity));
+  EXPECT_EQ(manager.Get<Position>(entity)->x, 1.f);
+  EXPECT_EQ(manager.Get<Position>(entity)->y, 2.f);
+  EXPECT_EQ(manager.Get<Name>(entity)->value, "player");
+
+  // assign again replaces the value in place
+  manager.Assign<Position>(entity, 3.f, 4.f);
+  EXPECT_EQ(manager.Get<Position>(entity)->x, 3.f);
+
+  manager.Remove<Position>(entity);
+  EXPECT_FALSE(manager.Has<Position>(entity));
+  EXPECT_EQ(manager.Get<Name>(entity)->value, "player");
+
+  manager.Destroy(entity);
+  EXPECT_FALSE(manager.Valid(entity));
+  EXPECT_EQ(manager.Size(), 0);
+}
+
+// entities with the same component set share an archetype and are stored contiguously
+TEST(EntityManagerTest, ArchetypeLayout) {
+  gs::EntityManager manager;
+  std::vector<gs::Entity> entities;
+  for (int i = 0; i < 10000; i++) {
+    auto entity = manager.Create();
+    manager.Assign<Position>(entity, static_cast<float>(i), 0.f);
+    manager.Assign<Velocity>(entity, 1.f, 0.f);
+    entities.push_back(entity);
+  }
+
+  gs::ComponentMask mask;
+  mask.set(Position::family());
+  mask.set(Velocity::family());
+  gs::Archetype* archetype = nullptr;
+  for (auto& item : manager.archetypes()) {
+    if (item->mask() == mask) {
+      archetype = item.get();
+    }
+  }
+  ASSERT_NE(archetype, nullptr);
+  EXPECT_EQ(archetype->size(), 10000);
+  EXPECT_GT(archetype->chunks().size(), 1);
+
+  int count = 0;
+  for (auto& chunk : archetype->chunks()) {
+    auto positions = archetype->Column<Position>(chunk);
+    auto velocities = archetype->Column<Velocity>(chunk);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(chunk.data) % CHUNK_ALIGNMENT, 0);
+    for (int i = 0; i < chunk.size; i++) {
+      positions[i].x += velocities[i].x;
+      count++;
+    }
+  }
+  EXPECT_EQ(count, 10000);
+  EXPECT_EQ(manager.Get<Position>(entities[42])->x, 43.f);
+}
+
+// destroying or moving entities keeps the remaining ones addressable
+TEST(EntityManagerTest, SwapRemove) {
+  gs::EntityManager manager;
+  std::vector<gs::Entity> entities;
+  for (int i = 0; i < 1000; i++) {
+    auto entity = manager.Create();
+    manager.Assign<Name>(entity, std::to_string(i));
+    entities.push_back(entity);
+  }
+  for (int i = 0; i < 1000; i += 2) {
+    manager.Destroy(entities[i]);
+  }
+  for (int i = 1; i < 1000; i += 4) {
+    manager.Assign<Position>(entities[i]);
+  }
+
+  EXPECT_EQ(manager.Size(), 500);
+  for (int i = 1; i < 1000; i += 2) {
+    ASSERT_TRUE(manager.Valid(entities[i]));
+    EXPECT_EQ(manager.Get<Name>(entities[i])->value, std::to_string(i));
+    EXPECT_EQ(manager.Has<Position>(entities[i]), i % 4 == 1);
+  }
+}
+
+// destroyed slots are recycled with a new version, stale handles are rejected
+TEST(EntityManagerTest, RecycleEntity) {
+  gs::EntityManager manager;
+  auto first = manager.Create();
+  manager.Assign<Position>(first, 1.f, 1.f);
+  manager.Destroy(first);
+
+  auto second = manager.Create();
+  EXPECT_EQ(second.index(), first.index());
+  EXPECT_NE(second.version(), first.version());
+  EXPECT_FALSE(manager.Valid(first));
+  EXPECT_TRUE(manager.Valid(second));
+  EXPECT_FALSE(manager.Has<Position>(second));
+  EXPECT_EQ(manager.Get<Position>(first), nullptr);
+  EXPECT_FALSE(manager.Valid(gs::Entity()));
+
+  // spawning and despawning does not grow the slot table
+  for (int frame = 0; frame < 100; frame++) {
+    std::vector<gs::Entity> particles;
+    for (int i = 0; i < 100; i++) {
+      particles.push_back(manager.Create());
+    }
+    for (auto& particle : particles) {
+      manager.Destroy(particle);
+    }
+  }
+  EXPECT_EQ(manager.Size(), 1);
+  EXPECT_LE(manager.Create().index(), 100);
+}
+
+struct Stunned : public gs::Component<Stunned> {
+  static constexpr bool SparseStorage = true;
+  Stunned() = default;
+  explicit Stunned(int frames) : frames(frames) {}
+  int frames = 0;
+};
+
+// sparse components are toggled without moving the entity between archetypes
+TEST(EntityManagerTest, SparseComponent) {
+  gs::EntityManager manager;
+  std::vector<gs::Entity> entities;
+  for (int i = 0; i < 10000; i++) {
+    auto entity = manager.Create();
+    manager.Assign<Position>(entity, static_cast<float>(i), 0.f);
+    entities.push_back(entity);
+  }
+  auto archetypes = manager.archetypes().size();
+  auto position = manager.Get<Position>(entities[42]);
+
+  for (int frame = 0; frame < 10; frame++) {
+    for (int i = 0; i < 10000; i++) {
+      manager.Assign<Stunned>(entities[i], i);
+    }
+    EXPECT_TRUE(manager.Has<Stunned>(entities[42]));
+    EXPECT_EQ(manager.Get<Stunned>(entities[42])->frames, 42);
+    for (int i = 0; i < 10000; i += 2) {
+      manager.Remove<Stunned>(entities[i]);
+    }
+    EXPECT_FALSE(manager.Has<Stunned>(entities[42]));
+    EXPECT_EQ(manager.Get<Stunned>(entities[43])->frames, 43);
+    for (int i = 1; i < 10000; i += 2) {
+      manager.Remove<Stunned>(entities[i]);
+    }
+  }
+  EXPECT_EQ(manager.archetypes().size(), archetypes);
+  EXPECT_EQ(manager.Get<Position>(entities[42]), position);
+  EXPECT_EQ(manager.View<const Position>().Size(), 10000);
+
+  int count = 0;
+  manager.Assign<Stunned>(entities[1], 1);
+  manager.Assign<Stunned>(entities[2], 2);
+  manager.ForEachSparse<Stunned>([&count, &manager](gs::Entity entity, Stunned& stunned) {
+    EXPECT_EQ(manager.Get<Position>(entity)->x, stunned.frames);
+    count++;
+  });
+  EXPECT_EQ(count, 2);
+
+  // destroying the entity drops its sparse components, a recycled slot does not inherit them
+  manager.Destroy(entities[1]);
+  EXPECT_FALSE(manager.Has<Stunned>(entities[1]));
+  EXPECT_FALSE(manager.Has<Stunned>(manager.Create()));
+  count = 0;
+  manager.ForEachSparse<Stunned>([&count](Stunned&) { count++; });
+  EXPECT_EQ(count, 1);
+}
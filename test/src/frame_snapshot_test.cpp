@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) 2026 by GallenShao, All Rights Reserved.
+ *
+ * frame_snapshot_test.cpp
+ *
+ *  Created on: 2026.10.17
+ *  Author: gallenshao
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <iterator>
+#include <new>
+#include <type_traits>
+
+#include "gs_ecs.h"
+#include "gs_ecs_test_header.h"
+
+struct Shielded : public gs::Component<Shielded> {
+  static constexpr bool SparseStorage = true;
+  static constexpr const char* SnapshotName = "Shielded";
+  int strength = 0;
+};
+
+// sum of all positions, to compare worlds
+static float PositionSum(gs::EntityManager& manager) {
+  float sum = 0;
+  manager.View<const Position>().ForEach([&sum](const Position& position) { sum += position.x + position.y; });
+  return sum;
+}
+
+TEST(FrameSnapshotTest, SharedColumns) {
+  gs::EntityManager manager;
+  std::vector<gs::Entity> entities;
+  for (int i = 0; i < 5000; i++) {
+    auto entity = manager.Create();
+    manager.Assign<Position>(entity, static_cast<float>(i), 0.f);
+    manager.Assign<Velocity>(entity);
+    entities.push_back(entity);
+  }
+
+  // captures happen between frames, after the tick moved past the writes of the frame
+  manager.SetTick(manager.tick() + 1);
+  auto first = gs::FrameSnapshot::Capture(manager);
+  ASSERT_NE(first, nullptr);
+  EXPECT_EQ(first->Size(), 5000);
+  EXPECT_GT(first->bytes(), 5000 * (sizeof(gs::Entity) + sizeof(Position) + sizeof(Velocity)) - 1);
+
+  manager.SetTick(manager.tick() + 1);
+  manager.Get<Position>(entities[42])->y = 1;
+  auto second = gs::FrameSnapshot::Capture(manager, first.get());
+
+  // only the written column of one chunk is sent
+  auto delta = gs::FrameSnapshot::Diff(*first, *second);
+  EXPECT_LT(delta.size(), 256);
+  auto full = gs::FrameSnapshot::Diff(gs::FrameSnapshot(), *second);
+  EXPECT_GT(full.size(), first->bytes());
+
+  auto applied = gs::FrameSnapshot::Apply(*first, delta);
+  ASSERT_NE(applied, nullptr);
+  gs::EntityManager client;
+  applied->Restore(client);
+  EXPECT_EQ(client.Size(), 5000);
+  EXPECT_EQ(client.Get<Position>(entities[42])->y, 1);
+  EXPECT_EQ(PositionSum(client), PositionSum(manager));
+
+  // deltas only apply on top of their base
+  EXPECT_EQ(gs::FrameSnapshot::Apply(*second, delta), nullptr);
+  EXPECT_EQ(gs::FrameSnapshot::Apply(gs::FrameSnapshot(), delta), nullptr);
+  delta.resize(delta.size() / 2);
+  EXPECT_EQ(gs::FrameSnapshot::Apply(*first, delta), nullptr);
+
+  // a patched block can not be larger than its base plus the bytes left in the delta
+  const uint8_t versions_header[] = {1, 0x20, 0x4e, 0, 0};  // BLOCK_PATCHED, 5000 slots of 4 bytes
+  auto header = std::search(full.begin(), full.end(), std::begin(versions_header), std::end(versions_header));
+  ASSERT_NE(header, full.end());
+  std::fill(header + 1, header + 5, 0xff);
+  EXPECT_EQ(gs::FrameSnapshot::Apply(gs::FrameSnapshot(), full), nullptr);
+
+  // only trivially copyable components can be captured
+  manager.Assign<Name>(entities[0], "name");
+  EXPECT_EQ(gs::FrameSnapshot::Capture(manager), nullptr);
+}
+
+// a manager created where a destroyed one lived does not share the columns captured from the old one
+TEST(FrameSnapshotTest, ReusedAddress) {
+  std::aligned_storage<sizeof(gs::EntityManager), alignof(gs::EntityManager)>::type storage;
+  auto manager = new (&storage) gs::EntityManager();
+  manager->Assign<Position>(manager->Create(), 1.f, 0.f);
+  manager->SetTick(manager->tick() + 2);
+  auto first = gs::FrameSnapshot::Capture(*manager);
+  ASSERT_NE(first, nullptr);
+  manager->~EntityManager();
+
+  manager = new (&storage) gs::EntityManager();
+  manager->Assign<Position>(manager->Create(), 2.f, 0.f);
+  auto second = gs::FrameSnapshot::Capture(*manager, first.get());
+  ASSERT_NE(second, nullptr);
+  gs::EntityManager client;
+  second->Restore(client);
+  EXPECT_EQ(PositionSum(client), 2);
+  manager->~EntityManager();
+}
+
+TEST(FrameSnapshotTest, Rollback) {
+  gs::EntityManager manager;
+  gs::SnapshotHistory history;
+  std::vector<gs::Entity> entities;
+  std::vector<float> sums;
+  for (int frame = 0; frame < 12; frame++) {
+    manager.SetTick(manager.tick() + 1);
+    manager.View<Position>().ForEach([](Position& position) { position.x += 1; });
+    for (int i = 0; i < 100; i++) {
+      auto entity = manager.Create();
+      manager.Assign<Position>(entity, static_cast<float>(frame), 0.f);
+      if (i % 3 == 0) {
+        manager.Assign<Shielded>(entity).strength = frame;
+      }
+      entities.push_back(entity);
+    }
+    manager.Destroy(entities[frame * 7]);
+    sums.push_back(PositionSum(manager));
+
+    manager.SetTick(manager.tick() + 1);
+    ASSERT_NE(history.Capture(manager), nullptr);
+  }
+  EXPECT_EQ(history.size(), DEFAULT_SNAPSHOT_HISTORY);
+  EXPECT_FALSE(history.Rollback(manager, DEFAULT_SNAPSHOT_HISTORY));
+
+  // back to the end of frame 8
+  ASSERT_TRUE(history.Rollback(manager, 3));
+  EXPECT_EQ(history.size(), DEFAULT_SNAPSHOT_HISTORY - 3);
+  EXPECT_EQ(manager.Size(), 900 - 9);
+  EXPECT_EQ(PositionSum(manager), sums[8]);
+  EXPECT_TRUE(manager.Valid(entities[899]));
+  EXPECT_FALSE(manager.Valid(entities[900]));
+  EXPECT_FALSE(manager.Valid(entities[8 * 7]));
+  EXPECT_EQ(manager.Get<Shielded>(entities[800])->strength, 8);
+
+  // simulating again on top of the restored world
+  manager.SetTick(manager.tick() + 1);
+  manager.View<Position>().ForEach([](Position& position) { position.x += 1; });
+  manager.SetTick(manager.tick() + 1);
+  ASSERT_NE(history.Capture(manager), nullptr);
+  ASSERT_TRUE(history.Rollback(manager, 1));
+  EXPECT_EQ(PositionSum(manager), sums[8]);
+}
+
+// the free slots keep their order, so that simulating again creates the same handles
+TEST(FrameSnapshotTest, HandleOrder) {
+  gs::EntityManager manager;
+  gs::SnapshotHistory history;
+  std::vector<gs::Entity> entities;
+  for (int i = 0; i < 10; i++) {
+    entities.push_back(manager.Create());
+    manager.Assign<Position>(entities.back());
+  }
+  manager.Destroy(entities[2]);
+  manager.Destroy(entities[7]);
+  auto snapshot = history.Capture(manager);
+  ASSERT_NE(snapshot, nullptr);
+
+  auto created = manager.Create();
+  ASSERT_TRUE(history.Rollback(manager, 0));
+  EXPECT_EQ(manager.Create(), created);
+
+  // a client restoring the replicated snapshot agrees on the handle
+  gs::EntityManager client;
+  gs::FrameSnapshot empty;
+  auto replicated = gs::FrameSnapshot::Apply(empty, gs::FrameSnapshot::Diff(empty, *snapshot));
+  ASSERT_NE(replicated, nullptr);
+  replicated->Restore(client);
+  EXPECT_EQ(client.Create(), created);
+}
+
+TEST(FrameSnapshotTest, Replication) {
+  gs::EntityManager server;
+  gs::EntityManager client;
+  std::shared_ptr<const gs::FrameSnapshot> server_snapshot = std::make_shared<gs::FrameSnapshot>();
+  std::shared_ptr<const gs::FrameSnapshot> client_snapshot = std::make_shared<gs::FrameSnapshot>();
+  std::vector<gs::Entity> entities;
+  for (int frame = 0; frame < 10; frame++) {
+    server.SetTick(server.tick() + 1);
+    for (int i = 0; i < 50; i++) {
+      auto entity = server.Create();
+      server.Assign<Position>(entity, static_cast<float>(i), static_cast<float>(frame));
+      if (i % 2 == 0) {
+        server.Assign<Velocity>(entity);
+      }
+      entities.push_back(entity);
+    }
+    server.Get<Position>(entities[frame * 2])->x = -1;
+    if (frame % 2 == 0) {
+      server.Destroy(entities[frame * 3 + 1]);
+    }
+    server.Assign<Shielded>(entities[frame * 5 + 2]).strength = frame;
+
+    server.SetTick(server.tick() + 1);
+    auto snapshot = gs::FrameSnapshot::Capture(server, server_snapshot.get());
+    auto delta = gs::FrameSnapshot::Diff(*server_snapshot, *snapshot);
+    server_snapshot = snapshot;
+
+    client_snapshot = gs::FrameSnapshot::Apply(*client_snapshot, delta);
+    ASSERT_NE(client_snapshot, nullptr);
+    client_snapshot->Restore(client);
+    EXPECT_EQ(client.Size(), server.Size());
+    EXPECT_EQ(PositionSum(client), PositionSum(server));
+  }
+  for (auto entity : entities) {
+    ASSERT_EQ(client.Valid(entity), server.Valid(entity));
+    if (server.Valid(entity)) {
+      EXPECT_EQ(client.Has<Velocity>(entity), server.Has<Velocity>(entity));
+      EXPECT_EQ(client.Has<Shielded>(entity), server.Has<Shielded>(entity));
+    }
+  }
+}
@@ -9,6 +9,8 @@
 
 #pragma once
 
+#include <string>
+
 class ASystem : public gs::System<ASystem> {};
 class BSystem : public gs::System<BSystem> {};
 class CSystem : public gs::System<CSystem> {};
@@ -17,4 +19,29 @@ class ESystem : public gs::System<ESystem> {};
 class FSystem : public gs::System<FSystem> {};
 
 class AThread : public gs::SystemThread<AThread> {};
-class BThread : public gs::SystemThread<BThread> {};
\ No newline at end of file
+class BThread : public gs::SystemThread<BThread> {};
+
+struct Position : public gs::Component<Position> {
+  Position() = default;
+  Position(float x, float y) : x(x), y(y) {}
+  float x = 0;
+  float y = 0;
+};
+
+struct Velocity : public gs::Component<Velocity> {
+  Velocity() = default;
+  Velocity(float x, float y) : x(x), y(y) {}
+  float x = 0;
+  float y = 0;
+};
+
+struct Name : public gs::Component<Name> {
+  explicit Name(std::string value) : value(std::move(value)) {}
+  std::string value;
+};
+
+struct Mass : public gs::Component<Mass> {
+  Mass() = default;
+  explicit Mass(float value) : value(value) {}
+  float value = 1;
+};
@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2026 by GallenShao, All Rights Reserved.
+ *
+ * profiler_test.cpp
+ *
+ *  Created on: 2026.10.17
+ *  Author: gallenshao
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "gs_ecs.h"
+
+template <int N>
+class SleepSystem : public gs::System<SleepSystem<N>> {
+ public:
+  void Update(gs::EntityManager& manager) override { std::this_thread::sleep_for(std::chrono::milliseconds(N)); }
+};
+
+class ProfiledSystem : public gs::System<ProfiledSystem> {};
+
+template <typename T>
+void TestProfiler() {
+  auto manager = gs::SystemManager::MakeFromTraverser<T>();
+  auto profiler = std::make_shared<gs::FrameProfiler>();
+  manager->SetProfiler(profiler);
+  manager->template AddSystem<SleepSystem<1>>();
+  manager->template AddSystem<SleepSystem<2>>().template WhichDependsOn<SleepSystem<1>>();
+  manager->template AddSystem<ProfiledSystem>();
+
+  gs::EntityManager dummy;
+  for (int i = 0; i < 10; i++) {
+    manager->Update(dummy);
+  }
+
+  ASSERT_EQ(profiler->events().size(), 30);
+  for (auto& event : profiler->events()) {
+    EXPECT_LE(event.ready, event.start);
+    EXPECT_LE(event.start, event.end);
+    EXPECT_GE(event.thread, 0);
+  }
+
+  auto stats = profiler->template GetStats<SleepSystem<2>>();
+  EXPECT_EQ(stats.samples, 10);
+  EXPECT_GE(stats.p50, 2000);
+  EXPECT_GE(stats.p99, stats.p50);
+  // SleepSystem<2> is only ready once SleepSystem<1> is done
+  EXPECT_GE(stats.wait_p50, 0);
+  EXPECT_EQ(profiler->template GetStats<ProfiledSystem>().samples, 10);
+
+  std::stringstream stream;
+  profiler->WriteChromeTrace(stream);
+  auto trace = stream.str();
+  EXPECT_EQ(trace.find("{\"traceEvents\":["), 0);
+  EXPECT_NE(trace.find("\"name\":\"ProfiledSystem\""), std::string::npos);
+  EXPECT_NE(trace.find("\"name\":\"SleepSystem<2>\""), std::string::npos);
+  EXPECT_NE(trace.find("\"wait_us\":"), std::string::npos);
+
+  profiler->Clear();
+  manager->SetProfiler(nullptr);
+  manager->Update(dummy);
+  EXPECT_TRUE(profiler->events().empty());
+}
+
+TEST(FrameProfilerTest, Traverser) {
+  TestProfiler<gs::SingleThreadTraverser>();
+  TestProfiler<gs::MultiThreadTraverser>();
+  TestProfiler<gs::WorkStealingTraverser>();
+}
+
+// each thread records into its own buffer without locking, full buffers drop events instead of blocking
+TEST(FrameProfilerTest, ThreadBuffers) {
+  gs::FrameProfiler profiler;
+  std::vector<std::thread> threads;
+  for (int thread = 0; thread < 4; thread++) {
+    threads.emplace_back([&profiler, thread]() {
+      for (int i = 0; i < 1000; i++) {
+        profiler.Record(thread, 0, i, i + 1);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  profiler.Collect();
+  EXPECT_EQ(profiler.events().size(), 4000);
+  EXPECT_EQ(profiler.dropped_count(), 0);
+  for (int family = 0; family < 4; family++) {
+    EXPECT_EQ(profiler.GetStats(family).samples, 120);
+  }
+
+  for (int i = 0; i < PROFILER_BUFFER_SIZE + 10; i++) {
+    profiler.Record(0, 0, 0, 0);
+  }
+  EXPECT_EQ(profiler.dropped_count(), 10);
+}
+
+static double TraceValue(const std::string& trace, const std::string& key) {
+  auto position = trace.find("\"" + key + "\":");
+  EXPECT_NE(position, std::string::npos);
+  return std::stod(trace.substr(position + key.size() + 3));
+}
+
+// timestamps keep their sub-microsecond digits however long the profiler has been running, here 3 s
+TEST(FrameProfilerTest, TracePrecision) {
+  gs::FrameProfiler profiler;
+  const int64_t second = 1000000000;
+  profiler.Record(0, 3 * second + 1001, 3 * second + 2345, 3 * second + 7891);
+  profiler.Collect();
+
+  std::stringstream stream;
+  profiler.WriteChromeTrace(stream);
+  auto trace = stream.str();
+  EXPECT_EQ(trace.find("e+"), std::string::npos);
+  EXPECT_NEAR(TraceValue(trace, "ts"), 3000002.345, 1e-4);
+  EXPECT_NEAR(TraceValue(trace, "dur"), 5.546, 1e-4);
+  EXPECT_NEAR(TraceValue(trace, "wait_us"), 1.344, 1e-4);
+}
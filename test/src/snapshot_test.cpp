@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2026 by GallenShao, All Rights Reserved.
+ *
+ * snapshot_test.cpp
+ *
+ *  Created on: 2026.10.17
+ *  Author: gallenshao
+ */
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include "archetype.h"
+#include "gs_ecs.h"
+#include "gs_ecs_test_header.h"
+
+struct Frozen : public gs::Component<Frozen> {
+  static constexpr bool SparseStorage = true;
+  static constexpr const char* SnapshotName = "Frozen";
+  int frames = 0;
+};
+
+TEST(SnapshotTest, RoundTrip) {
+  auto path = testing::TempDir() + "round_trip.snapshot";
+  gs::EntityManager manager;
+  std::vector<gs::Entity> entities;
+  for (int i = 0; i < 5000; i++) {
+    auto entity = manager.Create();
+    manager.Assign<Position>(entity, static_cast<float>(i), 0.f);
+    if (i % 2 == 0) {
+      manager.Assign<Velocity>(entity, 0.f, static_cast<float>(i));
+    }
+    if (i % 7 == 0) {
+      manager.Assign<Frozen>(entity).frames = i;
+    }
+    entities.push_back(entity);
+  }
+  std::vector<gs::Entity> destroyed;
+  for (int i = 0; i < 5000; i += 13) {
+    manager.Destroy(entities[i]);
+    destroyed.push_back(entities[i]);
+  }
+  manager.SetTick(42);
+  ASSERT_TRUE(gs::Snapshot::Save(manager, path));
+
+  gs::EntityManager restored;
+  ASSERT_TRUE(gs::Snapshot::Load(restored, path));
+  EXPECT_EQ(restored.Size(), manager.Size());
+  EXPECT_EQ(restored.tick(), 42);
+  for (int i = 0; i < 5000; i++) {
+    auto entity = entities[i];
+    ASSERT_EQ(restored.Valid(entity), i % 13 != 0);
+    if (i % 13 == 0) {
+      continue;
+    }
+    EXPECT_EQ(restored.Get<Position>(entity)->x, i);
+    EXPECT_EQ(restored.Has<Velocity>(entity), i % 2 == 0);
+    if (i % 2 == 0) {
+      EXPECT_EQ(restored.Get<Velocity>(entity)->y, i);
+    }
+    EXPECT_EQ(restored.Has<Frozen>(entity), i % 7 == 0);
+    if (i % 7 == 0) {
+      EXPECT_EQ(restored.Get<Frozen>(entity)->frames, i);
+    }
+  }
+
+  // the layout matches within a process, chunks are used in place
+  auto mapped = std::dynamic_pointer_cast<gs::MappedChunkAllocator>(restored.allocator());
+  ASSERT_NE(mapped, nullptr);
+  for (auto& archetype : restored.archetypes()) {
+    for (auto& chunk : archetype->chunks()) {
+      EXPECT_GE(chunk.data, mapped->data());
+      EXPECT_LT(chunk.data, mapped->data() + mapped->size());
+    }
+  }
+
+  // freed slots are reused in the same order as in the saved world, with their version bumped
+  auto entity = restored.Create();
+  EXPECT_EQ(entity, manager.Create());
+  EXPECT_EQ(entity.index(), destroyed.back().index());
+  EXPECT_NE(entity, destroyed.back());
+  manager.Destroy(entity);
+
+  // the restored world is writable, the file is left untouched
+  restored.View<Position>().ForEach([](Position& position) { position.y = 1; });
+  restored.Destroy(entities[1]);
+  for (int i = 0; i < 1000; i++) {
+    restored.Assign<Velocity>(restored.Create());
+  }
+  gs::EntityManager reloaded;
+  ASSERT_TRUE(gs::Snapshot::Load(reloaded, path));
+  EXPECT_EQ(reloaded.Size(), manager.Size());
+  EXPECT_EQ(reloaded.Get<Position>(entities[1])->y, 0);
+}
+
+TEST(SnapshotTest, Unsupported) {
+  auto path = testing::TempDir() + "unsupported.snapshot";
+  gs::EntityManager manager;
+  manager.Assign<Name>(manager.Create(), "name");
+  EXPECT_FALSE(gs::Snapshot::Save(manager, path));
+
+  gs::EntityManager restored;
+  EXPECT_FALSE(gs::Snapshot::Load(restored, testing::TempDir() + "missing.snapshot"));
+  std::ofstream(path) << "not a snapshot";
+  EXPECT_FALSE(gs::Snapshot::Load(restored, path));
+
+  // still usable
+  EXPECT_EQ(restored.Size(), 0);
+  EXPECT_TRUE(restored.Valid(restored.Create()));
+}
@@ -318,4 +318,469 @@ TEST(SystemManagerTest, MultiThreadTraverser4) {
   std::cout << "count: " << count << std::endl;
   // If there is only one CountThread, there will be no thread conflict.
   EXPECT_EQ(count, 1000 * 20);
-}
\ No newline at end of file
+}
+//  group_0
+//        ----------
+//        | A -> C | \    / --> D
+// E ---> |        |  ----
+//  \     | B      | /    \
+//   \    ----------       ---> F
+//    \                   /
+//     -------------------
+TEST(SystemManagerTest, WorkStealingTraverser) {
+  ResetTest();
+  auto manager = gs::SystemManager::MakeFromTraverser<gs::WorkStealingTraverser>();
+  manager->AddSystem<ESystem>().WithThread<DummyThread>();
+  ESystem::SetExpectedThread("DummyThread");
+
+  gs::SystemGroup group_0;
+  group_0.AddSystem<ASystem>();
+  group_0.AddSystem<BSystem>();
+  group_0.AddSystem<CSystem>().WhichDependsOn<ASystem>();
+  manager->AddSystemGroup(group_0).WithThread<OpenGLThread>().WhichDependsOn<ESystem>();
+  ASystem::SetExpectedThread("OpenGLThread");
+  BSystem::SetExpectedThread("OpenGLThread");
+  CSystem::SetExpectedThread("OpenGLThread");
+
+  manager->AddSystem<DSystem>().WhichDependsOn(group_0);
+  manager->AddSystem<FSystem>().WhichDependsOn(group_0).And<ESystem>();
+
+  manager->SetMaxThreadCount(4);
+  manager->SetMaxThreadCount<DummyThread>(2);
+  manager->SetMaxThreadCount<OpenGLThread>(2);
+
+  gs::EntityManager dummy;
+  for (int i = 0; i < 100; i++) {
+    manager->Update(dummy);
+  }
+  EXPECT_TRUE(D_called);
+  EXPECT_TRUE(F_called);
+  EXPECT_EQ(dummy_thread_count, 2);
+  EXPECT_EQ(open_gl_thread_count, 2);
+
+  manager = nullptr;
+  EXPECT_EQ(dummy_thread_count, 0);
+  EXPECT_EQ(open_gl_thread_count, 0);
+}
+
+// thread test
+TEST(SystemManagerTest, WorkStealingTraverser2) {
+  count = 0;
+  auto manager = gs::SystemManager::MakeFromTraverser<gs::WorkStealingTraverser>();
+
+  manager->AddSystem<CountSystem<0>>().WithThread<CountThread>();
+  manager->AddSystem<CountSystem<1>>().WithThread<CountThread>();
+  manager->AddSystem<CountSystem<2>>().WithThread<CountThread>();
+  manager->AddSystem<CountSystem<3>>().WithThread<CountThread>();
+  manager->AddSystem<CountSystem<4>>().WithThread<CountThread>();
+  manager->AddSystem<CountSystem<5>>().WithThread<CountThread>();
+  manager->AddSystem<CountSystem<6>>().WithThread<CountThread>();
+  manager->AddSystem<CountSystem<7>>().WithThread<CountThread>();
+  manager->AddSystem<CountSystem<8>>().WithThread<CountThread>();
+  manager->AddSystem<CountSystem<9>>().WithThread<CountThread>();
+
+  manager->SetMaxThreadCount<CountThread>(1);
+
+  gs::EntityManager dummy;
+  for (int i = 0; i < 1000; i++) {
+    manager->Update(dummy);
+  }
+  // If there is only one CountThread, there will be no thread conflict.
+  EXPECT_EQ(count, 1000 * 10);
+}
+
+struct Counter : public gs::Component<Counter> {
+  int value = 0;
+};
+
+class ParallelCountSystem : public gs::System<ParallelCountSystem> {
+ public:
+  typedef gs::ComponentList<Counter> Access;
+  void Update(gs::EntityManager& manager) override {
+    ParallelForEach(manager.View<Counter>(), [](Counter& counter) { counter.value++; });
+
+    std::atomic<int> chunks = {0};
+    ParallelForEachChunk(manager.View<const Counter>(),
+                         [&chunks](int size, const gs::Entity* entities, const Counter* counters) { chunks++; });
+    chunk_count = chunks.load();
+
+    std::atomic<int> rows = {0};
+    ParallelForEachBatch<4>(manager.View<const Counter>(),
+                            [&rows](int size, const gs::Entity* entities, const Counter* counters) { rows += size; });
+    row_count = rows.load();
+  }
+  int chunk_count = 0;
+  int row_count = 0;
+};
+
+template <typename T, typename... Args>
+void TestParallelFor(Args&&... args) {
+  gs::EntityManager entities;
+  for (int i = 0; i < 100000; i++) {
+    entities.Assign<Counter>(entities.Create());
+  }
+
+  auto manager = gs::SystemManager::MakeFromTraverser<T>(std::forward<Args>(args)...);
+  manager->template AddSystem<ParallelCountSystem>();
+  for (int i = 0; i < 10; i++) {
+    manager->Update(entities);
+  }
+
+  int total = 0;
+  entities.View<const Counter>().ForEach([&total](const Counter& counter) {
+    EXPECT_EQ(counter.value, 10);
+    total++;
+  });
+  EXPECT_EQ(total, 100000);
+  EXPECT_GT(manager->template Get<ParallelCountSystem>()->chunk_count, 1);
+  EXPECT_EQ(manager->template Get<ParallelCountSystem>()->row_count, 100000);
+}
+
+TEST(SystemManagerTest, ParallelFor) {
+  TestParallelFor<gs::SingleThreadTraverser>();
+  TestParallelFor<gs::MultiThreadTraverser>();
+  TestParallelFor<gs::WorkStealingTraverser>();
+}
+
+std::vector<int> chain_order;
+
+template <int I>
+class ChainSystem : public gs::System<ChainSystem<I>> {
+ public:
+  void Update(gs::EntityManager& manager) override { chain_order.push_back(I); }
+};
+
+template <typename T, int... Is>
+void AddChain(T& manager, std::integer_sequence<int, Is...>) {
+  manager->template AddSystem<ChainSystem<0>>();
+  (manager->template AddSystem<ChainSystem<Is + 1>>().template WhichDependsOn<ChainSystem<Is>>(), ...);
+}
+
+// the number of systems is only bounded by memory
+template <typename T, typename... Args>
+void TestManySystems(Args&&... args) {
+  const int count = 300;
+  auto manager = gs::SystemManager::MakeFromTraverser<T>(std::forward<Args>(args)...);
+  AddChain(manager, std::make_integer_sequence<int, count - 1>());
+
+  gs::EntityManager dummy;
+  for (int i = 0; i < 3; i++) {
+    chain_order.clear();
+    manager->Update(dummy);
+    ASSERT_EQ(chain_order.size(), count);
+    for (int index = 0; index < count; index++) {
+      EXPECT_EQ(chain_order[index], index);
+    }
+  }
+}
+
+TEST(SystemManagerTest, ManySystems) {
+  TestManySystems<gs::SingleThreadTraverser>();
+  TestManySystems<gs::MultiThreadTraverser>();
+  TestManySystems<gs::WorkStealingTraverser>();
+}
+
+static std::vector<int> rate_order;
+
+// counts its updates and the simulated time it was given
+template <int I>
+class RateSystem : public gs::System<RateSystem<I>> {
+ public:
+  void Update(gs::EntityManager& manager) override {
+    count++;
+    time += this->DeltaTime();
+    rate_order.push_back(I);
+  }
+  int count = 0;
+  double time = 0;
+};
+
+template <typename T>
+void TestTickRate() {
+  typedef RateSystem<0> Physics;
+  typedef RateSystem<1> AI;
+  typedef RateSystem<2> Render;
+  auto manager = gs::SystemManager::MakeFromTraverser<T>();
+  manager->template AddSystem<Physics>().WithTickRate(120);
+  gs::SystemGroup group;
+  group.AddSystem<AI>();
+  manager->AddSystemGroup(group).WithTickRate(10).template WhichDependsOn<Physics>();
+  // released by AI even when AI is not due
+  manager->template AddSystem<Render>().template WhichDependsOn<AI>();
+  auto physics = manager->template Get<Physics>();
+  auto ai = manager->template Get<AI>();
+  auto render = manager->template Get<Render>();
+
+  gs::EntityManager dummy;
+  for (int frame = 0; frame < 60; frame++) {
+    rate_order.clear();
+    manager->Update(dummy, 1.0 / 60);
+    // the render pass comes after the physics steps of the frame
+    ASSERT_EQ(rate_order.size(), frame % 6 == 5 ? 4 : 3);
+    EXPECT_EQ(rate_order.back(), 2);
+  }
+  EXPECT_EQ(physics->count, 120);
+  EXPECT_EQ(ai->count, 10);
+  EXPECT_EQ(render->count, 60);
+  EXPECT_NEAR(physics->time, 1, 1e-6);
+  EXPECT_NEAR(ai->time, 1, 1e-6);
+  EXPECT_NEAR(render->time, 1, 1e-6);
+
+  // a long frame is capped
+  manager->SetMaxCatchUpSteps(4);
+  manager->Update(dummy, 1);
+  EXPECT_EQ(physics->count, 124);
+  EXPECT_EQ(ai->count, 14);
+  EXPECT_EQ(render->count, 61);
+
+  // without dt every system runs once
+  manager->Update(dummy);
+  EXPECT_EQ(physics->count, 125);
+  EXPECT_EQ(ai->count, 15);
+  EXPECT_EQ(render->count, 62);
+}
+
+TEST(SystemManagerTest, TickRate) {
+  TestTickRate<gs::SingleThreadTraverser>();
+  TestTickRate<gs::MultiThreadTraverser>();
+  TestTickRate<gs::WorkStealingTraverser>();
+}
+
+static std::atomic<bool> render_started = {false};
+static std::atomic<bool> render_overlapped = {false};
+
+struct Transform : public gs::Component<Transform> {
+  Transform() = default;
+  explicit Transform(float x) : x(x) {}
+  float x = 0;
+};
+
+class RenderThread : public gs::SystemThread<RenderThread> {};
+
+class SimulateSystem : public gs::System<SimulateSystem> {
+ public:
+  typedef gs::ComponentList<Transform> Access;
+  void Update(gs::EntityManager& manager) override {
+    // the previous frame's render runs meanwhile
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+    while (wait_for_render && !render_started && std::chrono::steady_clock::now() < deadline) {
+      std::this_thread::yield();
+    }
+    render_overlapped = render_started.load();
+    manager.View<Transform>().ForEach([](Transform& transform) { transform.x++; });
+  }
+  bool wait_for_render = false;
+};
+
+class RenderSystem : public gs::System<RenderSystem> {
+ public:
+  typedef gs::ComponentList<const gs::Published<Transform>> Access;
+  static constexpr bool PipelineBoundary = true;
+  void Update(gs::EntityManager& manager) override {
+    render_started = true;
+    seen.clear();
+    manager.View<const gs::Published<Transform>>().ForEach(
+        [this](const gs::Published<Transform>& transform) { seen.push_back(transform.value.x); });
+  }
+  std::vector<float> seen;
+};
+
+static std::atomic<int> animate_finished = {0};
+
+struct Shade : public gs::Component<Shade> {
+  float value = 0;
+};
+
+class AnimateSystem : public gs::System<AnimateSystem> {
+ public:
+  typedef gs::ComponentList<Transform> Access;
+  void Update(gs::EntityManager& manager) override {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    animate_finished++;
+  }
+};
+
+class ShadeSystem : public gs::System<ShadeSystem> {
+ public:
+  typedef gs::ComponentList<Shade> Access;
+  static constexpr bool PipelineBoundary = true;
+  void Update(gs::EntityManager& manager) override {}
+};
+
+class LightSystem : public gs::System<LightSystem> {
+ public:
+  typedef gs::ComponentList<const Transform, Shade> Access;
+  void Update(gs::EntityManager& manager) override { seen = animate_finished.load(); }
+  int seen = 0;
+};
+
+// the render stage reads the previous frame's transforms and no longer waits for the simulation
+TEST(SystemManagerTest, Pipelining) {
+  auto manager = gs::SystemManager::MakeFromTraverser<gs::MultiThreadTraverser>();
+  manager->AddSystem<SimulateSystem>();
+  manager->AddSystem<RenderSystem>().WithThread<RenderThread>().WhichDependsOn<SimulateSystem>();
+  manager->EnablePipelining<Transform>();
+  auto simulate = manager->Get<SimulateSystem>();
+  auto render = manager->Get<RenderSystem>();
+
+  gs::EntityManager entities;
+  auto entity = entities.Create();
+  entities.Assign<Transform>(entity);
+  manager->Configure(entities);
+  EXPECT_EQ(entities.Get<gs::Published<Transform>>(entity)->value.x, 0);
+
+  simulate->wait_for_render = true;
+  for (int frame = 0; frame < 5; frame++) {
+    render_started = false;
+    manager->Update(entities);
+    EXPECT_TRUE(render_overlapped);
+    ASSERT_EQ(render->seen.size(), 1);
+    EXPECT_EQ(render->seen[0], frame);
+    EXPECT_EQ(entities.Get<Transform>(entity)->x, frame + 1);
+  }
+
+  // published copies follow the entities which gain or lose the component
+  entities.Remove<Transform>(entity);
+  entities.Assign<Transform>(entities.Create(), 10.f);
+  manager->Update(entities);
+  EXPECT_FALSE(entities.Has<gs::Published<Transform>>(entity));
+  manager->Update(entities);
+  ASSERT_EQ(render->seen.size(), 1);
+  EXPECT_EQ(render->seen[0], 11);
+
+  // LightSystem only follows AnimateSystem through ShadeSystem, the conflict survives cutting that path
+  animate_finished = 0;
+  manager = gs::SystemManager::MakeFromTraverser<gs::MultiThreadTraverser>();
+  manager->AddSystem<AnimateSystem>();
+  manager->AddSystem<ShadeSystem>().WhichDependsOn<AnimateSystem>();
+  manager->AddSystem<LightSystem>();
+  manager->EnablePipelining<Transform>();
+  auto light = manager->Get<LightSystem>();
+  for (int frame = 0; frame < 5; frame++) {
+    manager->Update(entities);
+    EXPECT_EQ(light->seen, frame + 1);
+  }
+}
+
+static std::vector<int> priority_order;
+
+template <int I>
+class PrioritySystem : public gs::System<PrioritySystem<I>> {
+ public:
+  void Update(gs::EntityManager& manager) override {
+    priority_order.push_back(I);
+    if (slow) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+  }
+  bool slow = false;
+};
+
+// ready systems start by the length of the chain behind them
+TEST(SystemManagerTest, CriticalPath) {
+  priority_order.clear();
+  auto manager = gs::SystemManager::MakeFromTraverser<gs::SingleThreadTraverser>();
+  manager->SetPriority(gs::SystemManager::CRITICAL_PATH);
+  // a leaf, then a chain of three, and a single slow system, all ready at once
+  manager->AddSystem<PrioritySystem<0>>();
+  manager->AddSystem<PrioritySystem<1>>();
+  manager->AddSystem<PrioritySystem<2>>().WhichDependsOn<PrioritySystem<1>>();
+  manager->AddSystem<PrioritySystem<3>>().WhichDependsOn<PrioritySystem<2>>();
+  manager->AddSystem<PrioritySystem<4>>();
+  manager->Get<PrioritySystem<4>>()->slow = true;
+
+  gs::EntityManager dummy;
+  manager->Update(dummy);
+  ASSERT_EQ(priority_order.size(), 5);
+  EXPECT_EQ(priority_order[0], 1);
+
+  // weighted by run time the slow one goes first from the second frame on
+  manager->SetPriority(gs::SystemManager::MEASURED_CRITICAL_PATH);
+  for (int frame = 0; frame < 2; frame++) {
+    priority_order.clear();
+    manager->Update(dummy);
+  }
+  ASSERT_EQ(priority_order.size(), 5);
+  EXPECT_EQ(priority_order[0], 4);
+  EXPECT_EQ(priority_order[1], 1);
+}
+
+class SlowRenderThread : public gs::SystemThread<SlowRenderThread> {};
+static std::atomic<int> slow_render_count = {0};
+
+template <int I>
+class SlowRenderSystem : public gs::System<SlowRenderSystem<I>> {
+ public:
+  void Update(gs::EntityManager& manager) override {
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    slow_render_count++;
+  }
+};
+
+template <int... Is>
+void AddSlowRenderSystems(std::shared_ptr<gs::SystemManager>& manager, std::integer_sequence<int, Is...>) {
+  (manager->AddSystem<SlowRenderSystem<Is>>().template WithThread<SlowRenderThread>(), ...);
+}
+
+// systems waiting for a busy thread are queued for it, the dispatcher sleeps instead of polling
+TEST(SystemManagerTest, MultiThreadTraverserPendingTasks) {
+  slow_render_count = 0;
+  auto manager = gs::SystemManager::MakeFromTraverser<gs::MultiThreadTraverser>();
+  AddSlowRenderSystems(manager, std::make_integer_sequence<int, 20>());
+  manager->SetMaxThreadCount<SlowRenderThread>(1);
+
+  gs::EntityManager dummy;
+  timespec cpu_begin, cpu_end;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu_begin);
+  auto begin = std::chrono::steady_clock::now();
+  manager->Update(dummy);
+  auto wall = std::chrono::steady_clock::now() - begin;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu_end);
+
+  EXPECT_EQ(slow_render_count, 20);
+  auto cpu = std::chrono::seconds(cpu_end.tv_sec - cpu_begin.tv_sec) +
+             std::chrono::nanoseconds(cpu_end.tv_nsec - cpu_begin.tv_nsec);
+  EXPECT_LT(cpu * 4, wall);
+}
+
+template <int MS>
+class DelaySystem : public gs::System<DelaySystem<MS>> {
+ public:
+  void Update(gs::EntityManager& manager) override { std::this_thread::sleep_for(std::chrono::milliseconds(MS)); }
+};
+
+// systems queued for a busy thread are taken by priority, not in the order they became ready
+TEST(SystemManagerTest, MultiThreadTraverserPendingPriority) {
+  priority_order.clear();
+  auto manager = gs::SystemManager::MakeFromTraverser<gs::MultiThreadTraverser>();
+  manager->SetPriority(gs::SystemManager::CRITICAL_PATH);
+  manager->SetMaxThreadCount<SlowRenderThread>(1);
+  manager->AddSystem<DelaySystem<50>>().WithThread<SlowRenderThread>();
+  // the leaf is queued first, the chain of three a little later
+  manager->AddSystem<DelaySystem<0>>();
+  manager->AddSystem<PrioritySystem<0>>().WithThread<SlowRenderThread>().WhichDependsOn<DelaySystem<0>>();
+  manager->AddSystem<DelaySystem<2>>();
+  manager->AddSystem<PrioritySystem<1>>().WithThread<SlowRenderThread>().WhichDependsOn<DelaySystem<2>>();
+  manager->AddSystem<PrioritySystem<2>>().WithThread<SlowRenderThread>().WhichDependsOn<PrioritySystem<1>>();
+  manager->AddSystem<PrioritySystem<3>>().WithThread<SlowRenderThread>().WhichDependsOn<PrioritySystem<2>>();
+
+  gs::EntityManager dummy;
+  manager->Update(dummy);
+  ASSERT_EQ(priority_order.size(), 4);
+  EXPECT_EQ(priority_order[0], 1);
+}
+
+// spinning threads pick up tasks without being notified, and still park once the budget runs out
+TEST(SystemManagerTest, SpinWaitStrategy) {
+  TestParallelFor<gs::MultiThreadTraverser>(gs::WaitStrategy::Spin());
+  TestParallelFor<gs::WorkStealingTraverser>(gs::WaitStrategy::Spin());
+  TestManySystems<gs::MultiThreadTraverser>(gs::WaitStrategy::Spin(MIN_SPIN_COUNT, 1));
+  TestManySystems<gs::WorkStealingTraverser>(gs::WaitStrategy::Spin(MIN_SPIN_COUNT, 1));
+
+  std::atomic<bool> ready = {false};
+  gs::SpinWaiter waiter(gs::WaitStrategy::Spin(MIN_SPIN_COUNT, 0));
+  EXPECT_FALSE(waiter.Poll([&ready]() { return ready.load(); }));
+  ready = true;
+  EXPECT_TRUE(waiter.Poll([&ready]() { return ready.load(); }));
+  EXPECT_FALSE(gs::SpinWaiter(gs::WaitStrategy::Park()).Poll([]() { return false; }));
+}
@@ -173,4 +173,105 @@ TEST(SystemGroupTest, GroupedSystemGroupWrongUsage13) {
   group_0.AddSystem<ASystem>().WithThread<AThread>();
   group_wrapper.AddSystemGroup(group_0).WithThread<AThread>();
   EXPECT_DEATH(manager.AddSystemGroup(group_wrapper).WithThread<BThread>(), "");
-}
\ No newline at end of file
+}
+static std::vector<std::string> access_order;
+
+template <typename... Ts>
+class AccessSystem : public gs::System<AccessSystem<Ts...>> {
+ public:
+  typedef gs::ComponentList<Ts...> Access;
+  void Update(gs::EntityManager& manager) override {
+    access_order.push_back(typeid(Access).name());
+  }
+};
+
+typedef AccessSystem<Position> WritePosition;
+typedef AccessSystem<const Position> ReadPosition0;
+typedef AccessSystem<const Position, Mass> ReadPosition1;
+typedef AccessSystem<Position, const Velocity> Integrate;
+typedef AccessSystem<Velocity> WriteVelocity;
+
+static int IndexOf(const std::string& name) {
+  auto it = std::find(access_order.begin(), access_order.end(), name);
+  return it == access_order.end() ? -1 : static_cast<int>(it - access_order.begin());
+}
+
+// dependencies are inferred from System::Access by registration order
+TEST(SystemGroupTest, InferDependencies) {
+  access_order.clear();
+  auto manager = gs::SystemManager::MakeFromTraverser<gs::SingleThreadTraverser>();
+  manager->AddSystem<WritePosition>();
+  manager->AddSystem<ReadPosition0>();
+  manager->AddSystem<ReadPosition1>();
+  manager->AddSystem<Integrate>();
+  manager->AddSystem<WriteVelocity>();
+
+  gs::EntityManager dummy;
+  manager->Update(dummy);
+  ASSERT_EQ(access_order.size(), 5);
+
+  auto write_position = IndexOf(typeid(WritePosition::Access).name());
+  auto read_position_0 = IndexOf(typeid(ReadPosition0::Access).name());
+  auto read_position_1 = IndexOf(typeid(ReadPosition1::Access).name());
+  auto integrate = IndexOf(typeid(Integrate::Access).name());
+  auto write_velocity = IndexOf(typeid(WriteVelocity::Access).name());
+  EXPECT_LT(write_position, read_position_0);
+  EXPECT_LT(write_position, read_position_1);
+  EXPECT_LT(read_position_0, integrate);
+  EXPECT_LT(read_position_1, integrate);
+  EXPECT_LT(integrate, write_velocity);
+}
+
+// readers of the same component do not depend on each other
+TEST(SystemGroupTest, InferDependenciesReaders) {
+  access_order.clear();
+  auto manager = gs::SystemManager::MakeFromTraverser<gs::SingleThreadTraverser>();
+  gs::SystemGroup group_0;
+  group_0.AddSystem<ReadPosition1>();
+  group_0.AddSystem<ReadPosition0>();
+  manager->AddSystemGroup(group_0);
+  manager->AddSystem<WritePosition>();
+
+  gs::EntityManager dummy;
+  manager->Update(dummy);
+  ASSERT_EQ(access_order.size(), 3);
+  EXPECT_EQ(access_order.back(), typeid(WritePosition::Access).name());
+}
+
+class ScheduleGroup : public gs::SystemGroup {
+ public:
+  using SystemGroup::all_systems_;
+};
+
+// A -> C -> D
+// B ------> D
+//           E
+TEST(FrameScheduleTest, Build) {
+  ScheduleGroup group;
+  group.AddSystem<ASystem>();
+  group.AddSystem<BSystem>();
+  group.AddSystem<CSystem>().WhichDependsOn<ASystem>();
+  group.AddSystem<DSystem>().WhichDependsOn<BSystem>().And<CSystem>();
+  group.AddSystem<ESystem>();
+
+  gs::FrameSchedule schedule;
+  schedule.Build(group.all_systems_);
+  EXPECT_EQ(schedule.size(), 5);
+  EXPECT_EQ(schedule.level_count(), 3);
+  EXPECT_EQ(schedule.root_count(), 3);
+
+  auto a = schedule.IndexOf(ASystem::family());
+  auto c = schedule.IndexOf(CSystem::family());
+  auto d = schedule.IndexOf(DSystem::family());
+  EXPECT_EQ(schedule.Level(a), 0);
+  EXPECT_EQ(schedule.Level(schedule.IndexOf(BSystem::family())), 0);
+  EXPECT_EQ(schedule.Level(schedule.IndexOf(ESystem::family())), 0);
+  EXPECT_EQ(schedule.Level(c), 1);
+  EXPECT_EQ(schedule.Level(d), 2);
+  EXPECT_EQ(schedule.InDegree(d), 2);
+  EXPECT_EQ(schedule.FamilyOf(d), DSystem::family());
+
+  ASSERT_EQ(schedule.SuccessorsEnd(a) - schedule.SuccessorsBegin(a), 1);
+  EXPECT_EQ(*schedule.SuccessorsBegin(a), c);
+  EXPECT_EQ(schedule.SuccessorsEnd(d), schedule.SuccessorsBegin(d));
+}
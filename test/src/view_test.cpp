@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2026 by GallenShao, All Rights Reserved.
+ *
+ * view_test.cpp
+ *
+ *  Created on: 2026.10.17
+ *  Author: gallenshao
+ */
+
+#include <gtest/gtest.h>
+
+#include "gs_ecs.h"
+#include "gs_ecs_test_header.h"
+
+TEST(ViewTest, ComponentMask) {
+  typedef gs::ComponentList<Position, Velocity, const Mass> List;
+  EXPECT_EQ(List::mask().count(), 3);
+  EXPECT_TRUE(List::mask().test(Mass::family()));
+  EXPECT_EQ(List::write_mask().count(), 2);
+  EXPECT_TRUE(List::write_mask().test(Position::family()));
+  EXPECT_TRUE(List::write_mask().test(Velocity::family()));
+  EXPECT_FALSE(List::write_mask().test(Mass::family()));
+}
+
+TEST(ViewTest, ForEach) {
+  gs::EntityManager manager;
+  for (int i = 0; i < 3000; i++) {
+    auto entity = manager.Create();
+    manager.Assign<Position>(entity, 0.f, 0.f);
+    if (i % 2 == 0) {
+      manager.Assign<Velocity>(entity, 1.f, 2.f);
+    }
+    if (i % 3 == 0) {
+      manager.Assign<Mass>(entity, 2.f);
+    }
+  }
+
+  auto view = manager.View<Position, const Velocity>();
+  EXPECT_EQ(view.Size(), 1500);
+  view.ForEach([](Position& position, const Velocity& velocity) {
+    position.x += velocity.x;
+    position.y += velocity.y;
+  });
+
+  int moved = 0;
+  manager.View<const Position>().ForEach([&moved](gs::Entity entity, const Position& position) {
+    if (position.x == 1.f && position.y == 2.f) {
+      moved++;
+    }
+  });
+  EXPECT_EQ(moved, 1500);
+
+  int count = 0;
+  manager.View<Position, Velocity, const Mass>().ForEachChunk(
+      [&count](int size, const gs::Entity* entities, Position* positions, Velocity* velocities, const Mass* masses) {
+        for (int i = 0; i < size; i++) {
+          positions[i].x += velocities[i].x * masses[i].value;
+        }
+        count += size;
+      });
+  EXPECT_EQ(count, 500);
+}
+
+struct Bulky : public gs::Component<Bulky> {
+  char data[4096] = {};
+};
+
+TEST(ViewTest, ForEachBatch) {
+  gs::EntityManager manager;
+  std::vector<gs::Entity> bulky;
+  for (int i = 0; i < 3001; i++) {
+    auto entity = manager.Create();
+    manager.Assign<Position>(entity, 0.f, 0.f);
+    manager.Assign<Velocity>(entity, 1.f, 2.f);
+    if (i % 1000 == 0) {
+      manager.Assign<Bulky>(entity);
+      bulky.push_back(entity);
+    }
+  }
+
+  // no tail handling, the lanes past `size` are padding
+  int count = 0;
+  manager.View<Position, const Velocity>().ForEachBatch<8>(
+      [&count](int size, const gs::Entity* entities, Position* positions, const Velocity* velocities) {
+        EXPECT_LE(size, 8);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(positions) % CHUNK_ALIGNMENT, 0);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(velocities) % CHUNK_ALIGNMENT, 0);
+        for (int i = 0; i < 8; i++) {
+          positions[i].x += velocities[i].x;
+          positions[i].y += velocities[i].y;
+        }
+        count += size;
+      });
+  EXPECT_EQ(count, 3001);
+
+  int moved = 0;
+  manager.View<const Position>().ForEach([&moved](const Position& position) {
+    moved += position.x == 1.f && position.y == 2.f;
+  });
+  EXPECT_EQ(moved, 3001);
+
+  // chunks too small for a whole batch of bulky entities grow to hold one, no row is left as padding
+  for (auto& archetype : manager.archetypes()) {
+    EXPECT_EQ(archetype->chunk_capacity() % MAX_BATCH_SIZE, 0);
+  }
+  count = 0;
+  manager.View<Position, const Bulky>().ForEachBatch<MAX_BATCH_SIZE>(
+      [&count](int size, const gs::Entity* entities, Position* positions, const Bulky*) {
+        for (int i = 0; i < MAX_BATCH_SIZE; i++) {
+          positions[i].x = 0;
+        }
+        count += size;
+      });
+  EXPECT_EQ(count, bulky.size());
+  for (auto entity : bulky) {
+    EXPECT_EQ(manager.Get<Position>(entity)->x, 0);
+  }
+
+  // new entities are constructed over the padding lanes
+  auto entity = manager.Create();
+  manager.Assign<Position>(entity, 5.f, 5.f);
+  manager.Assign<Bulky>(entity);
+  EXPECT_EQ(manager.Get<Position>(entity)->x, 5.f);
+}